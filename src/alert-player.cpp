@@ -0,0 +1,271 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "alert-player.h"
+#include "alert-sound.h"
+
+#include <obs-module.h>
+#include <plugin-support.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <util/util_uint64.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#define ALERT_SOURCE_ID "capture_checker_alert"
+#define ALERT_SOUND_FILE "capture-checker.wav"
+
+// How often the player looks for changed sound files while it has nothing to play
+#define REFRESH_MS 5000
+
+// Alerts are rare, a handful is plenty to ride out a burst while one is playing
+#define ALERT_QUEUE_SIZE 16
+
+// Audio is handed to OBS in small chunks, a little ahead of when it has to play
+#define CHUNK_MS 20
+#define LEAD_NS 40000000ULL
+
+static const char *alert_names[ALERT_COUNT] = {
+	"video timestamp", "audio timestamp",  "source enabled",   "frozen picture",
+	"audio silence",   "stuck audio",      "audio continuity", "desync",
+	"frame rate",      "uniform picture",  "test",
+};
+
+static std::mutex queue_mutex;
+static enum alert_id queue[ALERT_QUEUE_SIZE];
+static size_t queue_head = 0;
+static size_t queue_count = 0;
+static bool queued[ALERT_COUNT] = {};
+
+static std::thread player_thread;
+static std::atomic<bool> player_running{false};
+static os_event_t *player_event = nullptr;
+
+// Looked up in the plugin's config folder, which is per user and writable on every platform
+static const char *alert_file_names[ALERT_COUNT] = {
+	"capture-checker-video-timestamp.wav",
+	"capture-checker-audio-timestamp.wav",
+	"capture-checker-source-enabled.wav",
+	"capture-checker-frozen-picture.wav",
+	"capture-checker-audio-silence.wav",
+	"capture-checker-audio-loop.wav",
+	"capture-checker-audio-continuity.wav",
+	"capture-checker-desync.wav",
+	"capture-checker-frame-rate.wav",
+	"capture-checker-uniform-picture.wav",
+	nullptr,
+};
+
+// Decoded at load and refreshed while idle, so playing an alert never touches the disk.
+// Alerts without their own file use the default file, or the beep if that is missing too.
+static alert_sound_file default_file = {};
+static alert_sound_file alert_files[ALERT_COUNT] = {};
+static alert_sound beep = {};
+
+// Private, monitor-only source the alerts are played through. Created on the first alert so OBS
+// audio is fully up by then.
+static obs_source_t *alert_source = nullptr;
+
+static const char *alert_source_name(void *)
+{
+	return "Capture Checker Alert";
+}
+
+static void *alert_source_create(obs_data_t *, obs_source_t *source)
+{
+	return source;
+}
+
+static void alert_source_destroy(void *) {}
+
+static void refresh_sounds(void)
+{
+	if (default_file.path && alert_sound_file_refresh(&default_file))
+		obs_log(LOG_INFO, "Alert sound %s %s", default_file.path, default_file.loaded ? "loaded" : "not used");
+
+	for (size_t i = 0; i < ALERT_COUNT; i++) {
+		if (alert_files[i].path && alert_sound_file_refresh(&alert_files[i]) && alert_files[i].loaded)
+			obs_log(LOG_INFO, "Alert sound %s loaded", alert_files[i].path);
+	}
+}
+
+static const alert_sound *get_sound(enum alert_id id)
+{
+	if (alert_files[id].loaded)
+		return &alert_files[id].sound;
+	if (default_file.loaded)
+		return &default_file.sound;
+	return &beep;
+}
+
+static bool ensure_source(void)
+{
+	if (alert_source)
+		return true;
+
+	alert_source = obs_source_create_private(ALERT_SOURCE_ID, "capture-checker-alert", nullptr);
+	if (!alert_source)
+		return false;
+
+	obs_source_set_audio_mixers(alert_source, 0);
+	obs_source_set_monitoring_type(alert_source, OBS_MONITORING_TYPE_MONITOR_ONLY);
+	return true;
+}
+
+static void play_sound(enum alert_id id)
+{
+	obs_log(LOG_DEBUG, "Playing %s alert", alert_names[id]);
+
+	const alert_sound &sound = *get_sound(id);
+
+	if (!sound.frames || !ensure_source())
+		return;
+
+	struct obs_source_audio audio = {};
+	audio.speakers = sound.channels == 1 ? SPEAKERS_MONO : SPEAKERS_STEREO;
+	audio.format = AUDIO_FORMAT_FLOAT;
+	audio.samples_per_sec = sound.sample_rate;
+
+	// At least a frame, or the loop below would never advance
+	uint32_t chunk = sound.sample_rate * CHUNK_MS / 1000;
+	if (chunk < 1)
+		chunk = 1;
+	uint64_t start = os_gettime_ns() + LEAD_NS;
+
+	for (uint32_t offset = 0; offset < sound.frames && player_running; offset += chunk) {
+		uint64_t ts = start + util_mul_div64(offset, 1000000000ULL, sound.sample_rate);
+
+		audio.data[0] = (const uint8_t *)(sound.samples + (size_t)offset * sound.channels);
+		audio.frames = sound.frames - offset < chunk ? sound.frames - offset : chunk;
+		audio.timestamp = ts;
+
+		os_sleepto_ns(ts - LEAD_NS);
+		obs_source_output_audio(alert_source, &audio);
+	}
+}
+
+static bool pop_alert(enum alert_id *id)
+{
+	std::lock_guard<std::mutex> lock(queue_mutex);
+
+	if (!queue_count)
+		return false;
+
+	*id = queue[queue_head];
+	queue_head = (queue_head + 1) % ALERT_QUEUE_SIZE;
+	queue_count--;
+	queued[*id] = false;
+	return true;
+}
+
+static void player_loop()
+{
+	while (player_running) {
+		enum alert_id id;
+
+		while (player_running && pop_alert(&id))
+			play_sound(id);
+
+		if (os_event_timedwait(player_event, REFRESH_MS) == ETIMEDOUT)
+			refresh_sounds();
+	}
+}
+
+void alert_player_register(void)
+{
+	struct obs_source_info alert_info = {};
+	alert_info.id = ALERT_SOURCE_ID;
+	alert_info.type = OBS_SOURCE_TYPE_INPUT;
+	alert_info.output_flags = OBS_SOURCE_AUDIO | OBS_SOURCE_CAP_DISABLED;
+	alert_info.get_name = alert_source_name;
+	alert_info.create = alert_source_create;
+	alert_info.destroy = alert_source_destroy;
+
+	obs_register_source(&alert_info);
+}
+
+void alert_player_init(void)
+{
+	if (player_running)
+		return;
+
+	// Create the folder so there is somewhere obvious to put the files
+	char *dir = obs_module_config_path("");
+	if (dir && os_mkdirs(dir) != MKDIR_ERROR)
+		obs_log(LOG_INFO, "Custom alert sounds are read from %s", dir);
+	bfree(dir);
+
+	default_file.path = obs_module_config_path(ALERT_SOUND_FILE);
+	for (size_t i = 0; i < ALERT_COUNT; i++)
+		alert_files[i].path = alert_file_names[i] ? obs_module_config_path(alert_file_names[i]) : nullptr;
+
+	refresh_sounds();
+	alert_sound_make_tone(&beep, 48000, 880.0f, 300);
+
+	os_event_init(&player_event, OS_EVENT_TYPE_AUTO);
+	player_running = true;
+	player_thread = std::thread(player_loop);
+}
+
+void alert_player_free(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+
+		if (!player_running)
+			return;
+		player_running = false;
+	}
+
+	os_event_signal(player_event);
+	player_thread.join();
+
+	os_event_destroy(player_event);
+	player_event = nullptr;
+
+	obs_source_release(alert_source);
+	alert_source = nullptr;
+
+	alert_sound_file_free(&default_file);
+	bfree(default_file.path);
+	default_file.path = nullptr;
+	for (size_t i = 0; i < ALERT_COUNT; i++) {
+		alert_sound_file_free(&alert_files[i]);
+		bfree(alert_files[i].path);
+		alert_files[i].path = nullptr;
+	}
+	alert_sound_free(&beep);
+}
+
+bool alert_player_queue(enum alert_id id)
+{
+	std::lock_guard<std::mutex> lock(queue_mutex);
+
+	if (!player_running || queued[id] || queue_count == ALERT_QUEUE_SIZE)
+		return false;
+
+	queue[(queue_head + queue_count) % ALERT_QUEUE_SIZE] = id;
+	queue_count++;
+	queued[id] = true;
+
+	// Signalled under the lock so alert_player_free can't destroy the event in between
+	os_event_signal(player_event);
+	return true;
+}
@@ -0,0 +1,45 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+enum alert_id {
+	ALERT_VIDEO_TS,
+	ALERT_AUDIO_TS,
+	ALERT_SOURCE_ENABLED,
+	ALERT_FROZEN,
+	ALERT_SILENCE,
+	ALERT_AUDIO_LOOP,
+	ALERT_AUDIO_CONTINUITY,
+	ALERT_DESYNC,
+	ALERT_CADENCE,
+	ALERT_UNIFORM,
+	ALERT_TEST,
+	ALERT_COUNT,
+};
+
+// Registers the private source the alerts play through. Called from obs_module_load.
+void alert_player_register(void);
+
+// Decodes the alert sound and starts the playback thread. Called from obs_module_load.
+void alert_player_init(void);
+void alert_player_free(void);
+
+// Never waits for playback. Returns false if the alert was dropped because the queue is full or
+// the same alert is already waiting to be played.
+bool alert_player_queue(enum alert_id id);
@@ -0,0 +1,207 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "alert-sound.h"
+
+#include <obs-module.h>
+#include <util/platform.h>
+
+#include <math.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define WAV_FORMAT_PCM 1
+#define WAV_FORMAT_FLOAT 3
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+// Rates OBS can resample from, anything outside is a broken header rather than a real file
+#define MIN_SAMPLE_RATE 8000
+#define MAX_SAMPLE_RATE 384000
+
+static inline uint16_t read_u16(const uint8_t *p)
+{
+	return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t read_u32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static float read_sample(const uint8_t *p, uint16_t format, uint16_t bits)
+{
+	if (format == WAV_FORMAT_FLOAT) {
+		float v;
+		memcpy(&v, p, sizeof(v));
+		return v;
+	}
+
+	switch (bits) {
+	case 8:
+		return ((int)p[0] - 128) / 128.0f;
+	case 16:
+		return (int16_t)read_u16(p) / 32768.0f;
+	case 24:
+		return (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) / 2147483648.0f;
+	default:
+		return (int32_t)read_u32(p) / 2147483648.0f;
+	}
+}
+
+bool alert_sound_decode_wav(alert_sound *sound, const uint8_t *data, size_t size)
+{
+	if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0)
+		return false;
+
+	uint16_t format = 0, channels = 0, bits = 0;
+	uint32_t sample_rate = 0;
+	const uint8_t *pcm = nullptr;
+	size_t pcm_size = 0;
+
+	for (size_t pos = 12; pos + 8 <= size;) {
+		const uint8_t *chunk = data + pos;
+		size_t chunk_size = read_u32(chunk + 4);
+
+		if (chunk_size > size - pos - 8)
+			chunk_size = size - pos - 8;
+
+		if (memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16) {
+			format = read_u16(chunk + 8);
+			channels = read_u16(chunk + 10);
+			sample_rate = read_u32(chunk + 12);
+			bits = read_u16(chunk + 22);
+
+			// The real format is in the sub format GUID, whose first two bytes are the format tag
+			if (format == WAV_FORMAT_EXTENSIBLE && chunk_size >= 40)
+				format = read_u16(chunk + 32);
+		} else if (memcmp(chunk, "data", 4) == 0) {
+			pcm = chunk + 8;
+			pcm_size = chunk_size;
+		}
+
+		// Chunks are padded to an even size
+		pos += 8 + chunk_size + (chunk_size & 1);
+	}
+
+	bool supported = (format == WAV_FORMAT_PCM && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) ||
+			 (format == WAV_FORMAT_FLOAT && bits == 32);
+
+	if (!pcm || !supported || channels == 0 || sample_rate < MIN_SAMPLE_RATE || sample_rate > MAX_SAMPLE_RATE)
+		return false;
+
+	size_t frame_bytes = (size_t)channels * (bits / 8);
+	uint32_t out_channels = channels > 2 ? 2 : channels;
+
+	sound->frames = (uint32_t)(pcm_size / frame_bytes);
+	sound->channels = out_channels;
+	sound->sample_rate = sample_rate;
+	sound->samples = (float *)bmalloc((size_t)sound->frames * out_channels * sizeof(float));
+
+	for (uint32_t i = 0; i < sound->frames; i++) {
+		for (uint32_t c = 0; c < out_channels; c++)
+			sound->samples[i * out_channels + c] = read_sample(pcm + i * frame_bytes + c * (bits / 8), format,
+									   bits);
+	}
+
+	return sound->frames > 0;
+}
+
+bool alert_sound_load_wav(alert_sound *sound, const char *path)
+{
+	FILE *file = os_fopen(path, "rb");
+	if (!file)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	bool success = false;
+
+	if (size > 0) {
+		uint8_t *data = (uint8_t *)bmalloc((size_t)size);
+
+		if (fread(data, 1, (size_t)size, file) == (size_t)size)
+			success = alert_sound_decode_wav(sound, data, (size_t)size);
+
+		bfree(data);
+	}
+
+	fclose(file);
+	return success;
+}
+
+void alert_sound_make_tone(alert_sound *sound, uint32_t sample_rate, float frequency, uint32_t duration_ms)
+{
+	const double pi = 3.14159265358979323846;
+	uint32_t fade = sample_rate / 200;
+
+	sound->frames = (uint32_t)((uint64_t)sample_rate * duration_ms / 1000);
+	sound->channels = 1;
+	sound->sample_rate = sample_rate;
+	sound->samples = (float *)bmalloc((size_t)sound->frames * sizeof(float));
+
+	for (uint32_t i = 0; i < sound->frames; i++) {
+		// Short fades at both ends so the beep doesn't click
+		float gain = 0.5f;
+		if (i < fade)
+			gain *= (float)i / fade;
+		else if (sound->frames - i < fade)
+			gain *= (float)(sound->frames - i) / fade;
+
+		sound->samples[i] = gain * (float)sin(2.0 * pi * frequency * i / sample_rate);
+	}
+}
+
+void alert_sound_free(alert_sound *sound)
+{
+	bfree(sound->samples);
+	memset(sound, 0, sizeof(*sound));
+}
+
+bool alert_sound_file_refresh(alert_sound_file *file)
+{
+	struct stat st;
+
+	if (os_stat(file->path, &st) != 0) {
+		if (!file->loaded && !file->mtime)
+			return false;
+
+		alert_sound_free(&file->sound);
+		file->loaded = false;
+		file->mtime = 0;
+		return true;
+	}
+
+	if (file->mtime == st.st_mtime)
+		return false;
+
+	alert_sound_free(&file->sound);
+	file->mtime = st.st_mtime;
+	file->loaded = alert_sound_load_wav(&file->sound, file->path);
+	if (!file->loaded)
+		alert_sound_free(&file->sound);
+	return true;
+}
+
+void alert_sound_file_free(alert_sound_file *file)
+{
+	alert_sound_free(&file->sound);
+	file->loaded = false;
+	file->mtime = 0;
+}
@@ -0,0 +1,52 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+// Decoded alert clip: interleaved float PCM, ready for obs_source_output_audio.
+struct alert_sound {
+	float *samples;
+	uint32_t frames;
+	uint32_t channels;
+	uint32_t sample_rate;
+};
+
+// Decodes 8/16/24/32-bit integer or 32-bit float PCM WAV files. Keeps at most two channels.
+bool alert_sound_load_wav(alert_sound *sound, const char *path);
+bool alert_sound_decode_wav(alert_sound *sound, const uint8_t *data, size_t size);
+
+// Short sine beep, used when there is no alert sound file.
+void alert_sound_make_tone(alert_sound *sound, uint32_t sample_rate, float frequency, uint32_t duration_ms);
+
+void alert_sound_free(alert_sound *sound);
+
+// A WAV file on disk and its decoded contents, reloaded when the file's mtime changes.
+struct alert_sound_file {
+	char *path;
+	alert_sound sound;
+	time_t mtime;
+	bool loaded;
+};
+
+// Stats the file and decodes it again if it changed (or disappeared). Returns true if anything changed.
+bool alert_sound_file_refresh(alert_sound_file *file);
+void alert_sound_file_free(alert_sound_file *file);
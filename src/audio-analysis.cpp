@@ -0,0 +1,186 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "audio-analysis.h"
+#include "hash.h"
+#include "simd-kernels.h"
+
+#include <util/util_uint64.h>
+
+#define LEVEL_WINDOW_MS 300
+
+// Weight of the newest error in the smoothed jitter
+#define JITTER_SMOOTHING (1.0 / 16.0)
+
+// Looped buffers are exact copies, so a strided subset of the samples identifies a packet well enough
+#define LOOP_HASH_WORDS 128
+
+// A jump this big between packets (filter disabled, source restarted) starts the silence timers over
+#define RESTART_GAP_NS 1000000000ULL
+
+bool audio_levels_update(audio_levels *levels, const struct obs_audio_data *audio, size_t channels,
+			 uint32_t sample_rate, float threshold)
+{
+	if (channels > AUDIO_ANALYSIS_CHANNELS)
+		channels = AUDIO_ANALYSIS_CHANNELS;
+
+	if (!levels->started || audio->timestamp - levels->last_ts > RESTART_GAP_NS) {
+		levels->loud_ts = audio->timestamp;
+		levels->nonzero_ts = audio->timestamp;
+		levels->started = true;
+	}
+	levels->last_ts = audio->timestamp;
+
+	if (!audio->frames || !sample_rate)
+		return false;
+
+	// Exponential smoothing with a time constant of LEVEL_WINDOW_MS, whatever the packet size
+	float packet_ms = 1000.0f * audio->frames / sample_rate;
+	float decay = expf(-packet_ms / LEVEL_WINDOW_MS);
+
+	// Compared as mean squares, so there is no square root per channel
+	float threshold_sq = threshold * threshold;
+	bool loud = false;
+	bool nonzero = false;
+
+	for (size_t c = 0; c < channels; c++) {
+		const float *samples = (const float *)audio->data[c];
+		if (!samples)
+			continue;
+
+		float sum_sq, peak;
+		bool all_zero;
+		simd_audio_levels(samples, audio->frames, &sum_sq, &peak, &all_zero);
+
+		float mean_square = sum_sq / audio->frames;
+		levels->mean_square[c] = decay * levels->mean_square[c] + (1.0f - decay) * mean_square;
+		levels->peak[c] = peak > levels->peak[c] * decay ? peak : levels->peak[c] * decay;
+		levels->published_rms[c].store(sqrtf(levels->mean_square[c]), std::memory_order_relaxed);
+		levels->published_peak[c].store(levels->peak[c], std::memory_order_relaxed);
+
+		// The packet's own RMS rather than the smoothed level, which would hold off silence alerts for
+		// seconds after loud audio, and rather than peak, so a lone click doesn't count as sound
+		loud |= mean_square > threshold_sq;
+		nonzero |= !all_zero;
+	}
+	levels->published_channels.store((uint32_t)channels, std::memory_order_release);
+
+	levels->last_nonzero = nonzero;
+	if (loud)
+		levels->loud_ts = audio->timestamp;
+	if (nonzero)
+		levels->nonzero_ts = audio->timestamp;
+
+	return loud;
+}
+
+size_t audio_levels_get(const audio_levels *levels, float *rms, float *peak)
+{
+	size_t channels = levels->published_channels.load(std::memory_order_acquire);
+
+	for (size_t c = 0; c < channels; c++) {
+		rms[c] = levels->published_rms[c].load(std::memory_order_relaxed);
+		peak[c] = levels->published_peak[c].load(std::memory_order_relaxed);
+	}
+
+	return channels;
+}
+
+static uint64_t hash_packet(const struct obs_audio_data *audio, size_t channels)
+{
+	uint64_t hash = mix64(audio->frames);
+	size_t words = audio->frames * sizeof(float) / sizeof(uint64_t);
+	size_t step = words > LOOP_HASH_WORDS ? words / LOOP_HASH_WORDS : 1;
+
+	for (size_t c = 0; c < channels; c++) {
+		const uint8_t *data = audio->data[c];
+		if (!data)
+			continue;
+
+		for (size_t i = 0; i < words; i += step)
+			hash = mix64(hash ^ load64(data + i * sizeof(uint64_t)));
+	}
+
+	return hash;
+}
+
+bool audio_loop_update(audio_loop_detector *loop, const struct obs_audio_data *audio, size_t channels, bool silent)
+{
+	if (channels > AUDIO_ANALYSIS_CHANNELS)
+		channels = AUDIO_ANALYSIS_CHANNELS;
+
+	if (silent || !audio->frames) {
+		loop->loop_since_ts = 0;
+		return false;
+	}
+
+	uint64_t hash = hash_packet(audio, channels);
+	bool repeated = false;
+
+	for (size_t i = 0; i < loop->count; i++) {
+		if (loop->history[i] == hash) {
+			repeated = true;
+			break;
+		}
+	}
+
+	loop->history[loop->pos] = hash;
+	loop->pos = (loop->pos + 1) % AUDIO_LOOP_HISTORY;
+	if (loop->count < AUDIO_LOOP_HISTORY)
+		loop->count++;
+
+	if (!repeated)
+		loop->loop_since_ts = 0;
+	else if (!loop->loop_since_ts)
+		loop->loop_since_ts = audio->timestamp;
+
+	return repeated;
+}
+
+enum audio_continuity_result audio_continuity_update(audio_continuity *cont, uint64_t timestamp, uint32_t frames,
+						     uint32_t sample_rate, uint64_t tolerance_ns)
+{
+	enum audio_continuity_result result = AUDIO_CONTINUOUS;
+
+	if (!sample_rate)
+		return result;
+
+	cont->packets++;
+
+	if (cont->started) {
+		int64_t error = (int64_t)(timestamp - cont->expected_ts);
+		uint64_t abs_error = error < 0 ? (uint64_t)-error : (uint64_t)error;
+
+		if (abs_error > RESTART_GAP_NS) {
+			result = AUDIO_RESTART;
+		} else if (abs_error > tolerance_ns) {
+			result = error > 0 ? AUDIO_GAP : AUDIO_OVERLAP;
+			if (error > 0)
+				cont->gaps++;
+			else
+				cont->overlaps++;
+		} else {
+			cont->jitter_ns += JITTER_SMOOTHING * ((double)abs_error - cont->jitter_ns);
+		}
+	}
+
+	// Always continue from this packet, so one gap doesn't make every following packet look late
+	cont->expected_ts = timestamp + util_mul_div64(frames, 1000000000ULL, sample_rate);
+	cont->started = true;
+	return result;
+}
@@ -0,0 +1,105 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs-module.h>
+
+#include <math.h>
+
+#include <atomic>
+
+#define AUDIO_ANALYSIS_CHANNELS 8
+
+// Rolling levels and silence tracking of one source's audio, updated from filter_audio. The levels are
+// published as atomics so the properties dialog can read them while packets keep coming.
+struct audio_levels {
+	// Mean square smoothed over LEVEL_WINDOW_MS, and peak with the same decay
+	float mean_square[AUDIO_ANALYSIS_CHANNELS];
+	float peak[AUDIO_ANALYSIS_CHANNELS];
+
+	std::atomic<float> published_rms[AUDIO_ANALYSIS_CHANNELS];
+	std::atomic<float> published_peak[AUDIO_ANALYSIS_CHANNELS];
+	std::atomic<uint32_t> published_channels;
+
+	// Last packet where any channel's RMS was above the silence threshold, and where any sample was non-zero
+	uint64_t loud_ts;
+	uint64_t nonzero_ts;
+
+	uint64_t last_ts;
+	bool last_nonzero;
+	bool started;
+};
+
+// Room for a second or two of packets, depending on the packet size of the source
+#define AUDIO_LOOP_HISTORY 128
+
+// Catches devices that keep replaying the same buffer with fresh timestamps.
+struct audio_loop_detector {
+	uint64_t history[AUDIO_LOOP_HISTORY];
+	size_t pos;
+	size_t count;
+
+	// First packet of the current run of repeated packets, 0 when the audio isn't repeating
+	uint64_t loop_since_ts;
+};
+
+enum audio_continuity_result {
+	AUDIO_CONTINUOUS,
+	AUDIO_GAP,
+	AUDIO_OVERLAP,
+	AUDIO_RESTART,
+};
+
+// Compares every packet's timestamp with where the previous packet ended.
+struct audio_continuity {
+	uint64_t expected_ts;
+	bool started;
+
+	uint64_t packets;
+	uint64_t gaps;
+	uint64_t overlaps;
+
+	// Smoothed absolute timing error of the packets within tolerance
+	double jitter_ns;
+};
+
+// Returns true if the packet's RMS was above the threshold (linear amplitude) on any channel.
+bool audio_levels_update(audio_levels *levels, const struct obs_audio_data *audio, size_t channels,
+			 uint32_t sample_rate, float threshold);
+
+// Linear RMS and peak per channel. Returns the number of channels, 0 until the first packet.
+size_t audio_levels_get(const audio_levels *levels, float *rms, float *peak);
+
+static inline float db_to_mul(float db)
+{
+	return powf(10.0f, db / 20.0f);
+}
+
+static inline float mul_to_db(float mul)
+{
+	return mul > 0.0f ? 20.0f * log10f(mul) : -INFINITY;
+}
+
+// Fingerprints the packet and looks for it among the recent ones. Digitally silent packets are skipped,
+// since silence repeats by nature. Returns true while the audio is repeating.
+bool audio_loop_update(audio_loop_detector *loop, const struct obs_audio_data *audio, size_t channels, bool silent);
+
+// Errors beyond the tolerance count as a gap or an overlap, errors beyond a second as a restart.
+enum audio_continuity_result audio_continuity_update(audio_continuity *cont, uint64_t timestamp, uint32_t frames,
+						     uint32_t sample_rate, uint64_t tolerance_ns);
@@ -0,0 +1,54 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "av-sync.h"
+
+// Weight of the newest sample, roughly a one second window at 30-60 packets per second
+#define OFFSET_SMOOTHING (1.0 / 32.0)
+
+// Timestamp jumps bigger than this (source restarted, filter re-enabled) start the estimate over
+#define RESTART_GAP_NS 1000000000ULL
+
+void av_sync_update(av_sync_stream *stream, uint64_t media_ts, uint64_t ready_ns)
+{
+	double offset = (double)(int64_t)(media_ts - ready_ns);
+	uint64_t step = media_ts > stream->last_ts ? media_ts - stream->last_ts : stream->last_ts - media_ts;
+
+	if (!stream->started || step > RESTART_GAP_NS) {
+		stream->offset_ns = offset;
+		stream->started = true;
+		stream->restarts.fetch_add(1, std::memory_order_relaxed);
+	} else {
+		stream->offset_ns += OFFSET_SMOOTHING * (offset - stream->offset_ns);
+	}
+
+	stream->last_ts = media_ts;
+	stream->published_ns.store((int64_t)stream->offset_ns, std::memory_order_relaxed);
+	stream->valid.store(true, std::memory_order_release);
+}
+
+bool av_sync_desync(const av_sync_stream *video, const av_sync_stream *audio, int64_t *desync_ns, uint32_t *epoch)
+{
+	if (!video->valid.load(std::memory_order_acquire) || !audio->valid.load(std::memory_order_acquire))
+		return false;
+
+	*desync_ns = video->published_ns.load(std::memory_order_relaxed) -
+		     audio->published_ns.load(std::memory_order_relaxed);
+	*epoch = video->restarts.load(std::memory_order_relaxed) + audio->restarts.load(std::memory_order_relaxed);
+	return true;
+}
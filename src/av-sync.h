@@ -0,0 +1,47 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+// Smoothed offset between one stream's timestamps and the time they arrive on the checker clock.
+// Each stream is owned by its callback thread; only the published offset is shared.
+struct av_sync_stream {
+	double offset_ns;
+	uint64_t last_ts;
+	bool started;
+
+	std::atomic<int64_t> published_ns;
+	std::atomic<bool> valid;
+	// Counts the times the estimate started over
+	std::atomic<uint32_t> restarts;
+};
+
+// media_ts is when the data starts playing, the first sample of an audio packet or the start of a frame, for
+// both streams alike. ready_ns is when the filter callback got it. Async video reaches filter_video when the
+// frame is rendered, while filter_audio runs as audio is captured, so the offsets include OBS's own buffering
+// and the desync estimate carries the difference between the two as a constant bias.
+void av_sync_update(av_sync_stream *stream, uint64_t media_ts, uint64_t ready_ns);
+
+// Positive when video is stamped later than audio that arrives at the same time, so it plays behind the audio.
+// Returns false until both streams have data. epoch changes whenever either stream starts over, which is when a
+// baseline learned from the desync has to be learned again.
+bool av_sync_desync(const av_sync_stream *video, const av_sync_stream *audio, int64_t *desync_ns, uint32_t *epoch);
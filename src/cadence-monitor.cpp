@@ -0,0 +1,128 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "cadence-monitor.h"
+
+// Weight of the newest interval, roughly half a second at 60 fps
+#define INTERVAL_SMOOTHING (1.0 / 32.0)
+
+// Halving the histogram this often keeps it to the last few seconds of frames
+#define DECAY_FRAMES 256
+
+// Timestamp jumps bigger than this (source restarted, filter re-enabled) start the statistics over
+#define RESTART_GAP_NS 1000000000ULL
+
+#define MIN_FRAMES 32
+
+static void restart(cadence_monitor *cadence)
+{
+	for (size_t i = 0; i < CADENCE_BUCKETS; i++)
+		cadence->histogram[i].store(0, std::memory_order_relaxed);
+
+	cadence->interval_ns = 0.0;
+	cadence->jitter_ns = 0.0;
+	cadence->since_decay = 0;
+	cadence->frames.store(0, std::memory_order_relaxed);
+}
+
+void cadence_update(cadence_monitor *cadence, uint64_t timestamp)
+{
+	if (cadence->started && timestamp == cadence->last_ts)
+		return;
+
+	if (!cadence->started || timestamp < cadence->last_ts || timestamp - cadence->last_ts > RESTART_GAP_NS) {
+		restart(cadence);
+		cadence->last_ts = timestamp;
+		cadence->started = true;
+		return;
+	}
+
+	uint64_t delta = timestamp - cadence->last_ts;
+	cadence->last_ts = timestamp;
+
+	size_t bucket = (size_t)(delta / CADENCE_BUCKET_NS);
+	if (bucket >= CADENCE_BUCKETS)
+		bucket = CADENCE_BUCKETS - 1;
+	cadence->histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+
+	if (++cadence->since_decay == DECAY_FRAMES) {
+		for (size_t i = 0; i < CADENCE_BUCKETS; i++)
+			cadence->histogram[i].store(cadence->histogram[i].load(std::memory_order_relaxed) / 2,
+						    std::memory_order_relaxed);
+		cadence->since_decay = 0;
+	}
+
+	if (cadence->interval_ns == 0.0) {
+		cadence->interval_ns = (double)delta;
+	} else {
+		double error = (double)delta - cadence->interval_ns;
+		cadence->interval_ns += INTERVAL_SMOOTHING * error;
+		cadence->jitter_ns += INTERVAL_SMOOTHING * ((error < 0.0 ? -error : error) - cadence->jitter_ns);
+	}
+
+	cadence->published_interval_ns.store((uint64_t)cadence->interval_ns, std::memory_order_relaxed);
+	cadence->published_jitter_ns.store((uint64_t)cadence->jitter_ns, std::memory_order_relaxed);
+	cadence->frames.fetch_add(1, std::memory_order_release);
+}
+
+bool cadence_get_stats(const cadence_monitor *cadence, cadence_stats *stats)
+{
+	uint64_t frames = cadence->frames.load(std::memory_order_acquire);
+	uint64_t interval_ns = cadence->published_interval_ns.load(std::memory_order_relaxed);
+
+	if (frames < MIN_FRAMES || interval_ns == 0)
+		return false;
+
+	uint32_t counts[CADENCE_BUCKETS];
+	uint64_t total = 0;
+	size_t mode = 0;
+
+	for (size_t i = 0; i < CADENCE_BUCKETS; i++) {
+		counts[i] = cadence->histogram[i].load(std::memory_order_relaxed);
+		total += counts[i];
+		if (counts[i] > counts[mode])
+			mode = i;
+	}
+
+	if (total == 0)
+		return false;
+
+	// Buckets are narrow enough that a steady rate straddling a boundary lands in two of them
+	uint64_t on_time = counts[mode];
+	if (mode > 0)
+		on_time += counts[mode - 1];
+	if (mode + 1 < CADENCE_BUCKETS)
+		on_time += counts[mode + 1];
+
+	// Buckets starting at 1.5x the middle of the modal bucket or later
+	size_t first_late = (6 * mode + 6) / 4;
+	if (first_late < mode + 2)
+		first_late = mode + 2;
+
+	uint64_t late = 0;
+	for (size_t i = first_late; i < CADENCE_BUCKETS; i++)
+		late += counts[i];
+
+	stats->fps = 1000000000.0 / (double)interval_ns;
+	stats->jitter_ms = cadence->published_jitter_ns.load(std::memory_order_relaxed) / 1000000.0;
+	stats->modal_interval_ms = (mode + 0.5) * CADENCE_BUCKET_NS / 1000000.0;
+	stats->on_time = (double)on_time / (double)total;
+	stats->late = (double)late / (double)total;
+	stats->frames = frames;
+	return true;
+}
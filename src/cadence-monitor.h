@@ -0,0 +1,60 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+// 2 ms buckets cover frame intervals up to 126 ms (8 fps), the last bucket takes everything longer
+#define CADENCE_BUCKETS 64
+#define CADENCE_BUCKET_NS 2000000ULL
+
+// Frame timing of one source, updated from filter_video. The histogram and the published values are
+// atomics so the checker and the properties dialog can read them while frames keep coming.
+struct cadence_monitor {
+	uint64_t last_ts;
+	bool started;
+	double interval_ns;
+	double jitter_ns;
+	uint32_t since_decay;
+
+	std::atomic<uint32_t> histogram[CADENCE_BUCKETS];
+	std::atomic<uint64_t> published_interval_ns;
+	std::atomic<uint64_t> published_jitter_ns;
+	std::atomic<uint64_t> frames;
+};
+
+struct cadence_stats {
+	double fps;
+	double jitter_ms;
+
+	// Most common interval, and the share of frames near it or at least half an interval late
+	double modal_interval_ms;
+	double on_time;
+	double late;
+
+	uint64_t frames;
+};
+
+void cadence_update(cadence_monitor *cadence, uint64_t timestamp);
+
+// Returns false until enough frames were seen for the numbers to mean something.
+bool cadence_get_stats(const cadence_monitor *cadence, cadence_stats *stats);
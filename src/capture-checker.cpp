@@ -20,12 +20,21 @@ with this program. If not, see <https://www.gnu.org/licenses/>
 #include <obs-frontend-api.h>
 #include <plugin-support.h>
 
-#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-#include <Windows.h>
-#pragma comment(lib, "winmm.lib")
-#endif
-#include <chrono>
-#include <thread>
+#include "alert-player.h"
+#include "audio-analysis.h"
+#include "av-sync.h"
+#include "cadence-monitor.h"
+#include "checker-clock.h"
+#include "checker-scheduler.h"
+#include "frame-snapshot.h"
+#include "media-records.h"
+#include "simd-kernels.h"
+#include "video-analysis.h"
+
+#include <atomic>
+#include <math.h>
+#include <mutex>
+#include <stdio.h>
 
 OBS_DECLARE_MODULE()
 OBS_MODULE_USE_DEFAULT_LOCALE(PLUGIN_NAME, "en-US")
@@ -35,34 +44,265 @@ OBS_MODULE_USE_DEFAULT_LOCALE(PLUGIN_NAME, "en-US")
 #define SETTING_AUDIO_TS_CHECK "audio_ts_check"
 #define SETTING_SOURCE_ENABLED_CHECK "source_enabled_check"
 #define SETTING_SOURCE_ENABLED_TIME "source_enabled_time"
+#define SETTING_FROZEN_CHECK "frozen_check"
+#define SETTING_FROZEN_TIME "frozen_time"
+#define SETTING_FROZEN_MODE "frozen_mode"
+#define SETTING_FINGERPRINT_SAMPLES "fingerprint_samples"
+#define SETTING_PHASH_THRESHOLD "phash_threshold"
+#define SETTING_TILE_COLUMNS "tile_columns"
+#define SETTING_TILE_ROWS "tile_rows"
+#define SETTING_TILE_STATIC_AREA "tile_static_area"
+#define SETTING_SILENCE_CHECK "silence_check"
+#define SETTING_SILENCE_TIME "silence_time"
+#define SETTING_SILENCE_THRESHOLD "silence_threshold"
+#define SETTING_SILENCE_DIGITAL "silence_digital"
+#define SETTING_AUDIO_LOOP_CHECK "audio_loop_check"
+#define SETTING_AUDIO_LOOP_TIME "audio_loop_time"
+#define SETTING_CONTINUITY_CHECK "audio_continuity_check"
+#define SETTING_CONTINUITY_TOLERANCE "audio_continuity_tolerance"
+#define SETTING_JITTER_THRESHOLD "audio_jitter_threshold"
+#define SETTING_DESYNC_CHECK "desync_check"
+#define SETTING_DESYNC_THRESHOLD "desync_threshold"
+#define SETTING_UNIFORM_CHECK "uniform_check"
+#define SETTING_UNIFORM_TIME "uniform_time"
+#define SETTING_UNIFORM_THRESHOLD "uniform_threshold"
+#define SETTING_CADENCE_CHECK "cadence_check"
+#define SETTING_CADENCE_TOLERANCE "cadence_tolerance"
+#define SETTING_STUTTER_THRESHOLD "stutter_threshold"
+#define SETTING_CADENCE_STATS "cadence_stats"
+#define SETTING_CADENCE_REFRESH "cadence_refresh"
+#define SETTING_AUDIO_LEVELS "audio_levels"
+#define SETTING_AUDIO_LEVELS_REFRESH "audio_levels_refresh"
+#define SETTING_VIDEO_TS_INTERVAL "video_ts_interval"
+#define SETTING_AUDIO_TS_INTERVAL "audio_ts_interval"
+#define SETTING_SOURCE_ENABLED_INTERVAL "source_enabled_interval"
+#define SETTING_FROZEN_INTERVAL "frozen_interval"
+#define SETTING_SILENCE_INTERVAL "silence_interval"
+#define SETTING_AUDIO_LOOP_INTERVAL "audio_loop_interval"
+#define SETTING_CONTINUITY_INTERVAL "audio_continuity_interval"
+#define SETTING_DESYNC_INTERVAL "desync_interval"
+#define SETTING_CADENCE_INTERVAL "cadence_interval"
+#define SETTING_UNIFORM_INTERVAL "uniform_interval"
+#define SETTING_SIMD_TIER "simd_tier"
 #define SETTING_TEST_BEEP "test_beep"
 
-#define TEXT_BEEP_FILE_INFO \
-	obs_module_text(    \
-		"Place capture-checker.wav in the plugins folder (likely in C:\\Program Files\\obs-studio\\obs-plugins\\64bit) for custom alert sound.")
+#define TEXT_BEEP_FILE_INFO                                                                                          \
+	obs_module_text(                                                                                             \
+		"Put capture-checker.wav in the Capture Checker config folder, which the OBS log names, to "         \
+		"replace the alert beep, or capture-checker-<check>.wav such as capture-checker-frozen-picture.wav " \
+		"for a single check.")
 #define TEXT_VIDEO_TS_CHECK obs_module_text("Video timestamp check")
 #define TEXT_AUDIO_TS_CHECK obs_module_text("Audio timestamp check")
 #define TEXT_SOURCE_ENABLED_CHECK obs_module_text("Source enabled check")
 #define TEXT_SOURCE_ENABLED_TIME obs_module_text("Source enabled time until check in seconds")
+#define TEXT_FROZEN_CHECK obs_module_text("Frozen picture check")
+#define TEXT_FROZEN_TIME obs_module_text("Frozen picture time until alert in milliseconds")
+#define TEXT_FROZEN_MODE obs_module_text("Frozen picture detection")
+#define TEXT_FROZEN_MODE_FULL obs_module_text("Compare every pixel")
+#define TEXT_FROZEN_MODE_FINGERPRINT obs_module_text("Sampled fingerprint (fixed cost)")
+#define TEXT_FROZEN_MODE_TILES obs_module_text("Per-tile fingerprint (catches partly frozen pictures)")
+#define TEXT_FROZEN_MODE_PERCEPTUAL obs_module_text("Perceptual hash (tolerates noise and dithering)")
+#define TEXT_FINGERPRINT_SAMPLES obs_module_text("Fingerprint samples per plane (more catches smaller changes)")
+#define TEXT_PHASH_THRESHOLD obs_module_text("Perceptual hash bits that may differ on a frozen picture")
+#define TEXT_TILE_COLUMNS obs_module_text("Tile columns")
+#define TEXT_TILE_ROWS obs_module_text("Tile rows")
+#define TEXT_TILE_STATIC_AREA obs_module_text("Frozen area alert threshold in percent of the picture")
+#define TEXT_SILENCE_CHECK obs_module_text("Audio silence check")
+#define TEXT_SILENCE_TIME obs_module_text("Audio silence time until alert in milliseconds")
+#define TEXT_SILENCE_THRESHOLD obs_module_text("Audio silence threshold in dBFS RMS")
+#define TEXT_SILENCE_DIGITAL obs_module_text("Only alert on digital silence (every sample zero)")
+#define TEXT_AUDIO_LOOP_CHECK obs_module_text("Stuck audio buffer check")
+#define TEXT_AUDIO_LOOP_TIME obs_module_text("Repeating audio time until alert in milliseconds")
+#define TEXT_CONTINUITY_CHECK obs_module_text("Audio timestamp continuity check")
+#define TEXT_CONTINUITY_TOLERANCE obs_module_text("Audio gap/overlap tolerance in milliseconds")
+#define TEXT_JITTER_THRESHOLD obs_module_text("Audio jitter alert threshold in milliseconds (0 = off)")
+#define TEXT_DESYNC_CHECK obs_module_text("Video/Audio desync check")
+#define TEXT_DESYNC_THRESHOLD obs_module_text("Video/Audio drift alert threshold in milliseconds")
+#define TEXT_UNIFORM_CHECK obs_module_text("Black/uniform picture check")
+#define TEXT_UNIFORM_TIME obs_module_text("Black/uniform picture alert time in milliseconds")
+#define TEXT_UNIFORM_THRESHOLD obs_module_text("Black/uniform picture luma deviation threshold")
+#define TEXT_CADENCE_CHECK obs_module_text("Frame rate and cadence check")
+#define TEXT_CADENCE_TOLERANCE obs_module_text("Frame rate change alert threshold in percent")
+#define TEXT_STUTTER_THRESHOLD obs_module_text("Frame jitter alert threshold in milliseconds (0 = off)")
+#define TEXT_CADENCE_STATS_NONE obs_module_text("Measured frame rate: waiting for frames")
+#define TEXT_CADENCE_STATS \
+	obs_module_text("Measured frame rate: %.2f fps, %.2f ms jitter, %.1f%% of frames near %.0f ms, %.1f%% late")
+#define TEXT_CADENCE_REFRESH obs_module_text("Refresh Frame Rate")
+#define TEXT_AUDIO_LEVELS_NONE obs_module_text("Audio levels: waiting for audio")
+#define TEXT_AUDIO_LEVELS obs_module_text("Audio levels in dBFS, RMS / peak per channel:")
+#define TEXT_AUDIO_LEVELS_REFRESH obs_module_text("Refresh Audio Levels")
+#define TEXT_VIDEO_TS_INTERVAL obs_module_text("Video timestamp check interval in milliseconds")
+#define TEXT_AUDIO_TS_INTERVAL obs_module_text("Audio timestamp check interval in milliseconds")
+#define TEXT_SOURCE_ENABLED_INTERVAL obs_module_text("Source enabled check interval in milliseconds")
+#define TEXT_FROZEN_INTERVAL obs_module_text("Frozen picture check interval in milliseconds")
+#define TEXT_SILENCE_INTERVAL obs_module_text("Audio silence check interval in milliseconds")
+#define TEXT_AUDIO_LOOP_INTERVAL obs_module_text("Stuck audio buffer check interval in milliseconds")
+#define TEXT_CONTINUITY_INTERVAL obs_module_text("Audio timestamp continuity check interval in milliseconds")
+#define TEXT_DESYNC_INTERVAL obs_module_text("Video/Audio desync check interval in milliseconds")
+#define TEXT_CADENCE_INTERVAL obs_module_text("Frame rate and cadence check interval in milliseconds")
+#define TEXT_UNIFORM_INTERVAL obs_module_text("Black/uniform picture check interval in milliseconds")
+#define TEXT_SIMD_TIER obs_module_text("Analysis instruction set (shared by all Capture Checker filters)")
+#define TEXT_SIMD_TIER_AUTO obs_module_text("Best available")
 #define TEXT_TEST_BEEP obs_module_text("Test Alert Sound")
 
+#define MIN_CHECK_INTERVAL 50
+#define MAX_CHECK_INTERVAL 10000
+
+// How long to wait for the first frame before looking again, new frames wake the checker earlier
+#define IDLE_WAIT_NS 1000000000ULL
+
+// After a frame rate change, how long the measured rate has to stay within the tolerance before it is learned
+#define CADENCE_SETTLE_NS 2000000000ULL
+
+enum check_id {
+	CHECK_VIDEO_TS,
+	CHECK_AUDIO_TS,
+	CHECK_SOURCE_ENABLED,
+	CHECK_FROZEN,
+	CHECK_SILENCE,
+	CHECK_AUDIO_LOOP,
+	CHECK_CONTINUITY,
+	CHECK_DESYNC,
+	CHECK_CADENCE,
+	CHECK_UNIFORM,
+	CHECK_COUNT,
+};
+
+static const char *check_interval_settings[CHECK_COUNT] = {
+	SETTING_VIDEO_TS_INTERVAL,
+	SETTING_AUDIO_TS_INTERVAL,
+	SETTING_SOURCE_ENABLED_INTERVAL,
+	SETTING_FROZEN_INTERVAL,
+	SETTING_SILENCE_INTERVAL,
+	SETTING_AUDIO_LOOP_INTERVAL,
+	SETTING_CONTINUITY_INTERVAL,
+	SETTING_DESYNC_INTERVAL,
+	SETTING_CADENCE_INTERVAL,
+	SETTING_UNIFORM_INTERVAL,
+};
+
+enum frozen_mode {
+	FROZEN_MODE_FULL,
+	FROZEN_MODE_FINGERPRINT,
+	FROZEN_MODE_TILES,
+	FROZEN_MODE_PERCEPTUAL,
+};
+
+// Owned by the scheduler thread
+struct checker_state {
+	uint64_t frame_ts;
+	uint64_t audio_ts;
+	bool audio_seen;
+
+	// Frames and packets with a new timestamp since the check last ran
+	size_t new_frames;
+	size_t new_packets;
+
+	bool prev_visible;
+	uint64_t not_visible_since_ts;
+
+	// Continuity counters as of the last check
+	uint64_t audio_gaps;
+	uint64_t audio_overlaps;
+
+	// Frame rate the cadence check compares against, 0 until it's learned from the source
+	double cadence_fps;
+	// After a frame rate alert, the rate the average is heading for and since when it has stayed near it
+	bool cadence_settling;
+	double cadence_settle_fps;
+	uint64_t cadence_settle_ts;
+
+	// Desync the drift is measured from, learned once both streams have data and again when either restarts.
+	// OBS's buffering puts a constant offset between the streams even when they are in sync.
+	int64_t desync_baseline_ns;
+	uint32_t desync_epoch;
+	bool desync_learned;
+
+	uint64_t next_check[CHECK_COUNT];
+};
+
 struct capture_checker_data {
 	obs_source_t *context;
-	obs_source_t *source;
+	// The parent, looked up by whichever of the video and audio threads gets there first
+	std::atomic<obs_source_t *> source;
 
 	obs_data_t *settings;
 
-	obs_source_frame *current_frame;
-	obs_audio_data *current_audio;
+	snapshot_pool frames;
+	video_record_ring video_records;
+	audio_record_ring audio_records;
 
 	bool video_ts_check;
 	bool audio_ts_check;
 	bool source_enabled_check;
 	uint16_t source_enabled_time;
+	bool frozen_check;
+	uint32_t frozen_time;
+	int frozen_mode;
+	uint32_t fingerprint_samples;
+	uint32_t phash_threshold;
+	uint32_t tile_columns;
+	uint32_t tile_rows;
+	uint32_t tile_static_area;
+	bool silence_check;
+	uint32_t silence_time;
+	float silence_threshold;
+	bool silence_digital;
+	bool audio_loop_check;
+	uint32_t audio_loop_time;
+	bool continuity_check;
+	uint32_t continuity_tolerance;
+	uint32_t jitter_threshold;
+	bool desync_check;
+	uint32_t desync_threshold;
+	bool cadence_check;
+	uint32_t cadence_tolerance;
+	uint32_t stutter_threshold;
+	bool uniform_check;
+	uint32_t uniform_time;
+	uint32_t uniform_threshold;
+	uint32_t check_interval[CHECK_COUNT];
+
+	scheduler_entry checker;
+	std::atomic<bool> checker_reset;
+	std::atomic<bool> wants_media;
+	checker_state state;
 
-	std::thread thread;
-	bool thread_active;
 	// How long since the frame has changed?
+	frame_compare frame_cmp;
+	frame_fingerprint frame_fp;
+	tile_map tiles;
+	perceptual_hash phash;
+
+	// Shared by the content checks, only rebuilt on frames one of them looks at
+	luma_pyramid pyramid;
+	uint64_t last_uniform_ts;
+	bool luma_valid;
+	float luma_mean;
+	float luma_variance;
+	uint64_t last_compare_ts;
+	uint64_t content_changed_ts;
+	uint64_t uniform_since_ts;
+
+	// Owned by the audio thread, the timestamps are published for the checker
+	audio_levels levels;
+	std::atomic<uint64_t> audio_loud_ts;
+	std::atomic<uint64_t> audio_nonzero_ts;
+	audio_loop_detector loop;
+	std::atomic<uint64_t> audio_loop_since_ts;
+	audio_continuity continuity;
+	std::atomic<uint64_t> audio_gaps;
+	std::atomic<uint64_t> audio_overlaps;
+	std::atomic<uint64_t> audio_jitter_ns;
+	// Set on a gap or overlap so the check runs right away instead of at its next interval
+	std::atomic<bool> continuity_event;
+
+	// Video side updated from filter_video, audio side from filter_audio
+	av_sync_stream video_sync;
+	av_sync_stream audio_sync;
+
+	// Fed from filter_video, also read by the properties dialog
+	cadence_monitor cadence;
 
 	signal_handler_t *signal_handler;
 };
@@ -72,6 +312,24 @@ static const char *filter_name(void *)
 	return obs_module_text("Capture Checker");
 }
 
+// The kernels are shared by every filter. The last filter to force a tier owns it, and filters left on auto
+// don't undo it until the owner goes back to auto or is destroyed.
+static std::mutex simd_tier_mutex;
+static const void *simd_tier_owner = nullptr;
+
+static void update_simd_tier(const void *filter, enum simd_tier tier)
+{
+	std::lock_guard<std::mutex> lock(simd_tier_mutex);
+
+	if (tier != SIMD_TIER_AUTO) {
+		simd_tier_owner = filter;
+		simd_kernels_select(tier);
+	} else if (simd_tier_owner == filter) {
+		simd_tier_owner = nullptr;
+		simd_kernels_select(SIMD_TIER_AUTO);
+	}
+}
+
 static void filter_update(void *data, obs_data_t *settings)
 {
 	struct capture_checker_data *filter = (capture_checker_data *)data;
@@ -81,6 +339,10 @@ static void filter_update(void *data, obs_data_t *settings)
 	bool new_source_enabled_check = (bool)obs_data_get_bool(settings, SETTING_SOURCE_ENABLED_CHECK);
 
 	uint16_t new_source_enabled_time = (uint16_t)obs_data_get_int(settings, SETTING_SOURCE_ENABLED_TIME);
+	bool new_frozen_check = (bool)obs_data_get_bool(settings, SETTING_FROZEN_CHECK);
+	uint32_t new_frozen_time = (uint32_t)obs_data_get_int(settings, SETTING_FROZEN_TIME);
+	int new_frozen_mode = (int)obs_data_get_int(settings, SETTING_FROZEN_MODE);
+	uint32_t new_fingerprint_samples = (uint32_t)obs_data_get_int(settings, SETTING_FINGERPRINT_SAMPLES);
 
 	if (new_video_ts_check != filter->video_ts_check)
 		filter->video_ts_check = new_video_ts_check;
@@ -94,35 +356,83 @@ static void filter_update(void *data, obs_data_t *settings)
 	if (new_source_enabled_time != filter->source_enabled_time)
 		filter->source_enabled_time = new_source_enabled_time;
 
-	// TODO: Setting for how long the frame can be the same (ie. filter is getting frames with new timestamp but contents are not changing)
+	if (new_frozen_check != filter->frozen_check || new_frozen_mode != filter->frozen_mode) {
+		filter->frozen_check = new_frozen_check;
+		filter->frozen_mode = new_frozen_mode;
+		// Don't measure the freeze from a reference taken before the check was turned on
+		filter->frame_cmp.valid = false;
+		filter->frame_fp.valid = false;
+		filter->tiles.valid = false;
+		filter->phash.valid = false;
+	}
+
+	if (new_frozen_time != filter->frozen_time)
+		filter->frozen_time = new_frozen_time;
+
+	if (new_fingerprint_samples != filter->fingerprint_samples)
+		filter->fingerprint_samples = new_fingerprint_samples;
+
+	filter->silence_check = obs_data_get_bool(settings, SETTING_SILENCE_CHECK);
+	filter->silence_time = (uint32_t)obs_data_get_int(settings, SETTING_SILENCE_TIME);
+	filter->silence_threshold = db_to_mul((float)obs_data_get_int(settings, SETTING_SILENCE_THRESHOLD));
+	filter->silence_digital = obs_data_get_bool(settings, SETTING_SILENCE_DIGITAL);
+	filter->audio_loop_check = obs_data_get_bool(settings, SETTING_AUDIO_LOOP_CHECK);
+	filter->audio_loop_time = (uint32_t)obs_data_get_int(settings, SETTING_AUDIO_LOOP_TIME);
+	filter->continuity_check = obs_data_get_bool(settings, SETTING_CONTINUITY_CHECK);
+	filter->continuity_tolerance = (uint32_t)obs_data_get_int(settings, SETTING_CONTINUITY_TOLERANCE);
+	filter->jitter_threshold = (uint32_t)obs_data_get_int(settings, SETTING_JITTER_THRESHOLD);
+	filter->phash_threshold = (uint32_t)obs_data_get_int(settings, SETTING_PHASH_THRESHOLD);
+	filter->tile_columns = (uint32_t)obs_data_get_int(settings, SETTING_TILE_COLUMNS);
+	filter->tile_rows = (uint32_t)obs_data_get_int(settings, SETTING_TILE_ROWS);
+	filter->tile_static_area = (uint32_t)obs_data_get_int(settings, SETTING_TILE_STATIC_AREA);
+	filter->desync_check = obs_data_get_bool(settings, SETTING_DESYNC_CHECK);
+	filter->desync_threshold = (uint32_t)obs_data_get_int(settings, SETTING_DESYNC_THRESHOLD);
+	filter->cadence_check = obs_data_get_bool(settings, SETTING_CADENCE_CHECK);
+	filter->cadence_tolerance = (uint32_t)obs_data_get_int(settings, SETTING_CADENCE_TOLERANCE);
+	filter->stutter_threshold = (uint32_t)obs_data_get_int(settings, SETTING_STUTTER_THRESHOLD);
+	filter->uniform_check = obs_data_get_bool(settings, SETTING_UNIFORM_CHECK);
+	filter->uniform_time = (uint32_t)obs_data_get_int(settings, SETTING_UNIFORM_TIME);
+	filter->uniform_threshold = (uint32_t)obs_data_get_int(settings, SETTING_UNIFORM_THRESHOLD);
+
+	update_simd_tier(filter, (enum simd_tier)obs_data_get_int(settings, SETTING_SIMD_TIER));
+
+	for (size_t i = 0; i < CHECK_COUNT; i++) {
+		uint32_t interval = (uint32_t)obs_data_get_int(settings, check_interval_settings[i]);
+
+		if (interval < MIN_CHECK_INTERVAL)
+			interval = MIN_CHECK_INTERVAL;
+
+		filter->check_interval[i] = interval;
+	}
+
+	// Let the checker pick up the new intervals right away
+	if (filter->checker.active)
+		checker_scheduler_wake(&filter->checker);
 }
 
-void thread_loop(void *data);
+uint64_t run_checks(void *data, uint64_t now);
 
-void start_thread(void *data)
+void start_checker(void *data)
 {
 	struct capture_checker_data *filter = (capture_checker_data *)data;
 
-	if (filter->thread_active || !obs_source_enabled(filter->context))
+	if (filter->checker.active || !obs_source_enabled(filter->context))
 		return;
 
-	filter->thread_active = true;
-	filter->thread = std::thread(thread_loop, (void *)filter);
+	// The scheduler thread owns the checker state, so let it do the reset on its next run
+	filter->checker_reset = true;
+	checker_scheduler_activate(&filter->checker);
 }
 
-void end_thread(void *data)
+void end_checker(void *data)
 {
 	struct capture_checker_data *filter = (capture_checker_data *)data;
 
-	if (!filter->thread_active)
+	if (!filter->checker.active)
 		return;
 
-	filter->thread_active = false;
-
-	filter->thread.join();
-
-	filter->current_frame = nullptr;
-	obs_log(LOG_INFO, "Thread ended");
+	checker_scheduler_deactivate(&filter->checker);
+	obs_log(LOG_INFO, "Checker stopped");
 }
 
 static void filter_enabled(void *data, calldata_t *calldata)
@@ -130,16 +440,15 @@ static void filter_enabled(void *data, calldata_t *calldata)
 	bool enabled = calldata_bool(calldata, "enabled");
 
 	if (enabled)
-		start_thread(data);
+		start_checker(data);
 	else
-		end_thread(data);
+		end_checker(data);
 }
 
 void frontend_event(obs_frontend_event event, void *)
 {
-	if (event == OBS_FRONTEND_EVENT_SCRIPTING_SHUTDOWN) {
-		// TODO: try condition variable for stopping the thread when exiting OBS
-	}
+	if (event == OBS_FRONTEND_EVENT_SCRIPTING_SHUTDOWN || event == OBS_FRONTEND_EVENT_EXIT)
+		checker_scheduler_stop();
 }
 
 static void *filter_create(obs_data_t *settings, obs_source_t *context)
@@ -152,12 +461,12 @@ static void *filter_create(obs_data_t *settings, obs_source_t *context)
 
 	filter->settings = settings;
 
-	filter->current_frame = nullptr;
+	snapshot_pool_init(&filter->frames);
 
 	filter->signal_handler = obs_source_get_signal_handler(context);
 	signal_handler_connect(filter->signal_handler, "enable", filter_enabled, filter);
 
-	obs_frontend_add_event_callback(frontend_event, filter);
+	checker_scheduler_register(&filter->checker, run_checks, filter);
 
 	return filter;
 }
@@ -168,86 +477,401 @@ static void filter_destroy(void *data)
 
 	signal_handler_disconnect(filter->signal_handler, "enable", filter_enabled, filter);
 
-	end_thread(data);
+	checker_scheduler_unregister(&filter->checker);
+	update_simd_tier(filter, SIMD_TIER_AUTO);
+
+	frame_compare_free(&filter->frame_cmp);
+	tile_map_free(&filter->tiles);
+	luma_pyramid_free(&filter->pyramid);
 	bfree(data);
 }
 
-void play_alert_sound()
+bool test_alert_sound(obs_properties_t *, obs_property_t *, void *)
 {
-#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
-	// TODO: Different sound files for different checks
-	PlaySound((TEXT("../../obs-plugins/64bit/capture-checker.wav")), NULL, SND_FILENAME);
-#endif
+	alert_player_queue(ALERT_TEST);
+
+	return true;
 }
 
-bool test_alert_sound(obs_properties_t *, obs_property_t *, void *)
+bool refresh_stats(obs_properties_t *, obs_property_t *, void *)
 {
-	play_alert_sound();
-
+	// Returning true has OBS rebuild the properties, which reads the stats again
 	return true;
 }
 
-static obs_properties_t *filter_properties(void *)
+static obs_properties_t *filter_properties(void *data)
 {
+	struct capture_checker_data *filter = (capture_checker_data *)data;
 	obs_properties_t *props = obs_properties_create();
 
 	obs_properties_add_text(props, SETTING_BEEP_FILE_INFO, TEXT_BEEP_FILE_INFO, OBS_TEXT_INFO);
 	obs_properties_add_bool(props, SETTING_VIDEO_TS_CHECK, TEXT_VIDEO_TS_CHECK);
+	obs_properties_add_int(props, SETTING_VIDEO_TS_INTERVAL, TEXT_VIDEO_TS_INTERVAL, MIN_CHECK_INTERVAL,
+			       MAX_CHECK_INTERVAL, 10);
 	obs_properties_add_bool(props, SETTING_AUDIO_TS_CHECK, TEXT_AUDIO_TS_CHECK);
+	obs_properties_add_int(props, SETTING_AUDIO_TS_INTERVAL, TEXT_AUDIO_TS_INTERVAL, MIN_CHECK_INTERVAL,
+			       MAX_CHECK_INTERVAL, 10);
 	obs_properties_add_bool(props, SETTING_SOURCE_ENABLED_CHECK, TEXT_SOURCE_ENABLED_CHECK);
 	obs_properties_add_int_slider(props, SETTING_SOURCE_ENABLED_TIME, TEXT_SOURCE_ENABLED_TIME, 1, 60 * 60, 1);
+	obs_properties_add_int(props, SETTING_SOURCE_ENABLED_INTERVAL, TEXT_SOURCE_ENABLED_INTERVAL,
+			       MIN_CHECK_INTERVAL, MAX_CHECK_INTERVAL, 10);
+	obs_properties_add_bool(props, SETTING_FROZEN_CHECK, TEXT_FROZEN_CHECK);
+	obs_properties_add_int(props, SETTING_FROZEN_TIME, TEXT_FROZEN_TIME, 100, 60 * 60 * 1000, 100);
+	obs_properties_add_int(props, SETTING_FROZEN_INTERVAL, TEXT_FROZEN_INTERVAL, MIN_CHECK_INTERVAL,
+			       MAX_CHECK_INTERVAL, 10);
+
+	obs_properties_add_bool(props, SETTING_SILENCE_CHECK, TEXT_SILENCE_CHECK);
+	obs_properties_add_int(props, SETTING_SILENCE_TIME, TEXT_SILENCE_TIME, 100, 60 * 60 * 1000, 100);
+	obs_properties_add_int_slider(props, SETTING_SILENCE_THRESHOLD, TEXT_SILENCE_THRESHOLD, -100, 0, 1);
+	obs_properties_add_bool(props, SETTING_SILENCE_DIGITAL, TEXT_SILENCE_DIGITAL);
+	obs_properties_add_int(props, SETTING_SILENCE_INTERVAL, TEXT_SILENCE_INTERVAL, MIN_CHECK_INTERVAL,
+			       MAX_CHECK_INTERVAL, 10);
+
+	float rms[AUDIO_ANALYSIS_CHANNELS];
+	float peak[AUDIO_ANALYSIS_CHANNELS];
+	size_t channels = filter ? audio_levels_get(&filter->levels, rms, peak) : 0;
+	char levels_text[256];
+
+	if (channels) {
+		int len = snprintf(levels_text, sizeof(levels_text), "%s", TEXT_AUDIO_LEVELS);
+		for (size_t c = 0; c < channels && len > 0 && (size_t)len < sizeof(levels_text); c++)
+			len += snprintf(levels_text + len, sizeof(levels_text) - len, "%s%.1f / %.1f", c ? ", " : " ",
+					mul_to_db(rms[c]), mul_to_db(peak[c]));
+	} else {
+		snprintf(levels_text, sizeof(levels_text), "%s", TEXT_AUDIO_LEVELS_NONE);
+	}
+	obs_properties_add_text(props, SETTING_AUDIO_LEVELS, levels_text, OBS_TEXT_INFO);
+	obs_properties_add_button(props, SETTING_AUDIO_LEVELS_REFRESH, TEXT_AUDIO_LEVELS_REFRESH, refresh_stats);
+
+	obs_properties_add_bool(props, SETTING_AUDIO_LOOP_CHECK, TEXT_AUDIO_LOOP_CHECK);
+	obs_properties_add_int(props, SETTING_AUDIO_LOOP_TIME, TEXT_AUDIO_LOOP_TIME, 100, 60 * 1000, 100);
+	obs_properties_add_int(props, SETTING_AUDIO_LOOP_INTERVAL, TEXT_AUDIO_LOOP_INTERVAL, MIN_CHECK_INTERVAL,
+			       MAX_CHECK_INTERVAL, 10);
+
+	obs_properties_add_bool(props, SETTING_CONTINUITY_CHECK, TEXT_CONTINUITY_CHECK);
+	obs_properties_add_int(props, SETTING_CONTINUITY_TOLERANCE, TEXT_CONTINUITY_TOLERANCE, 1, 1000, 1);
+	obs_properties_add_int(props, SETTING_JITTER_THRESHOLD, TEXT_JITTER_THRESHOLD, 0, 1000, 1);
+	obs_properties_add_int(props, SETTING_CONTINUITY_INTERVAL, TEXT_CONTINUITY_INTERVAL, MIN_CHECK_INTERVAL,
+			       MAX_CHECK_INTERVAL, 10);
+
+	obs_properties_add_bool(props, SETTING_DESYNC_CHECK, TEXT_DESYNC_CHECK);
+	obs_properties_add_int(props, SETTING_DESYNC_THRESHOLD, TEXT_DESYNC_THRESHOLD, 1, 10000, 1);
+	obs_properties_add_int(props, SETTING_DESYNC_INTERVAL, TEXT_DESYNC_INTERVAL, MIN_CHECK_INTERVAL,
+			       MAX_CHECK_INTERVAL, 10);
+
+	obs_properties_add_bool(props, SETTING_UNIFORM_CHECK, TEXT_UNIFORM_CHECK);
+	obs_properties_add_int(props, SETTING_UNIFORM_TIME, TEXT_UNIFORM_TIME, 100, 60 * 60 * 1000, 100);
+	obs_properties_add_int_slider(props, SETTING_UNIFORM_THRESHOLD, TEXT_UNIFORM_THRESHOLD, 0, 32, 1);
+	obs_properties_add_int(props, SETTING_UNIFORM_INTERVAL, TEXT_UNIFORM_INTERVAL, MIN_CHECK_INTERVAL,
+			       MAX_CHECK_INTERVAL, 10);
+
+	obs_properties_add_bool(props, SETTING_CADENCE_CHECK, TEXT_CADENCE_CHECK);
+	obs_properties_add_int(props, SETTING_CADENCE_TOLERANCE, TEXT_CADENCE_TOLERANCE, 1, 100, 1);
+	obs_properties_add_int(props, SETTING_STUTTER_THRESHOLD, TEXT_STUTTER_THRESHOLD, 0, 1000, 1);
+	obs_properties_add_int(props, SETTING_CADENCE_INTERVAL, TEXT_CADENCE_INTERVAL, MIN_CHECK_INTERVAL,
+			       MAX_CHECK_INTERVAL, 10);
+
+	cadence_stats stats;
+	char stats_text[256];
+
+	if (filter && cadence_get_stats(&filter->cadence, &stats))
+		snprintf(stats_text, sizeof(stats_text), TEXT_CADENCE_STATS, stats.fps, stats.jitter_ms,
+			 stats.on_time * 100.0, stats.modal_interval_ms, stats.late * 100.0);
+	else
+		snprintf(stats_text, sizeof(stats_text), "%s", TEXT_CADENCE_STATS_NONE);
+	obs_properties_add_text(props, SETTING_CADENCE_STATS, stats_text, OBS_TEXT_INFO);
+	obs_properties_add_button(props, SETTING_CADENCE_REFRESH, TEXT_CADENCE_REFRESH, refresh_stats);
+
+	obs_property_t *mode = obs_properties_add_list(props, SETTING_FROZEN_MODE, TEXT_FROZEN_MODE,
+						       OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+	obs_property_list_add_int(mode, TEXT_FROZEN_MODE_FULL, FROZEN_MODE_FULL);
+	obs_property_list_add_int(mode, TEXT_FROZEN_MODE_FINGERPRINT, FROZEN_MODE_FINGERPRINT);
+	obs_property_list_add_int(mode, TEXT_FROZEN_MODE_TILES, FROZEN_MODE_TILES);
+	obs_property_list_add_int(mode, TEXT_FROZEN_MODE_PERCEPTUAL, FROZEN_MODE_PERCEPTUAL);
+	obs_properties_add_int_slider(props, SETTING_FINGERPRINT_SAMPLES, TEXT_FINGERPRINT_SAMPLES, 16, 4096, 16);
+	obs_properties_add_int_slider(props, SETTING_PHASH_THRESHOLD, TEXT_PHASH_THRESHOLD, 0, 32, 1);
+	obs_properties_add_int_slider(props, SETTING_TILE_COLUMNS, TEXT_TILE_COLUMNS, 1, TILE_MAP_MAX, 1);
+	obs_properties_add_int_slider(props, SETTING_TILE_ROWS, TEXT_TILE_ROWS, 1, TILE_MAP_MAX, 1);
+	obs_properties_add_int_slider(props, SETTING_TILE_STATIC_AREA, TEXT_TILE_STATIC_AREA, 1, 100, 1);
+
+	obs_property_t *tier = obs_properties_add_list(props, SETTING_SIMD_TIER, TEXT_SIMD_TIER, OBS_COMBO_TYPE_LIST,
+						       OBS_COMBO_FORMAT_INT);
+	obs_property_list_add_int(tier, TEXT_SIMD_TIER_AUTO, SIMD_TIER_AUTO);
+	for (int i = SIMD_TIER_COUNT - 1; i > SIMD_TIER_AUTO; i--) {
+		if (simd_tier_supported((enum simd_tier)i))
+			obs_property_list_add_int(tier, simd_tier_name((enum simd_tier)i), i);
+	}
 	obs_properties_add_button(props, SETTING_TEST_BEEP, TEXT_TEST_BEEP, test_alert_sound);
 
 	return props;
 }
 
-void thread_loop(void *data)
+uint64_t run_checks(void *data, uint64_t now)
 {
 	struct capture_checker_data *filter = (capture_checker_data *)data;
+	checker_state *state = &filter->state;
+
+	if (filter->checker_reset.exchange(false)) {
+		*state = {};
+		state->audio_gaps = filter->audio_gaps;
+		state->audio_overlaps = filter->audio_overlaps;
+		snapshot_pool_reset_reader(&filter->frames);
+		spsc_clear(&filter->video_records);
+		spsc_clear(&filter->audio_records);
+	}
+
+	video_record video;
+	while (spsc_pop(&filter->video_records, &video)) {
+		if (video.timestamp != state->frame_ts)
+			state->new_frames++;
+		state->frame_ts = video.timestamp;
+	}
 
-	uint64_t frame_ts = 0;
-	uint64_t audio_ts = 0;
+	audio_record audio;
+	while (spsc_pop(&filter->audio_records, &audio)) {
+		if (!state->audio_seen || audio.timestamp != state->audio_ts)
+			state->new_packets++;
+		state->audio_ts = audio.timestamp;
+		state->audio_seen = true;
+	}
 
-	bool prev_visible = false;
-	uint64_t not_visible_since_ts = 0;
+	const frame_snapshot *frame = snapshot_pool_acquire(&filter->frames);
 
-	while (filter->thread_active) {
-		if (filter->current_frame == nullptr) {
-			std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-			continue;
-		}
+	// Audio-only sources never get a frame, so only wait for one until audio turns up
+	if (frame == nullptr && !state->audio_seen) {
+		filter->wants_media = true;
+		return now + IDLE_WAIT_NS;
+	}
 
-		if (filter->video_ts_check && frame_ts - filter->current_frame->timestamp == 0) {
+	bool due[CHECK_COUNT];
+
+	for (size_t i = 0; i < CHECK_COUNT; i++) {
+		// First round after the media starts only schedules, so every check gets a full interval of data
+		if (state->next_check[i] == 0)
+			state->next_check[i] = now + 1000000ULL * filter->check_interval[i];
+
+		due[i] = now >= state->next_check[i];
+		if (i == CHECK_CONTINUITY && filter->continuity_event.exchange(false))
+			due[i] = true;
+		if (due[i])
+			state->next_check[i] = now + 1000000ULL * filter->check_interval[i];
+	}
+
+	// The video checks have nothing to look at until a frame arrives
+	if (due[CHECK_VIDEO_TS] && frame) {
+		if (filter->video_ts_check && state->new_frames == 0) {
 			obs_log(LOG_INFO, "Video timestamp check alert!");
-			play_alert_sound();
+			alert_player_queue(ALERT_VIDEO_TS);
 		}
+		state->new_frames = 0;
+	}
 
-		// TODO: Check for difference in data of video and audio
+	if (due[CHECK_FROZEN] && frame && filter->frozen_check) {
+		if (filter->frozen_mode == FROZEN_MODE_TILES) {
+			if (frame->static_area * 100.0f >= filter->tile_static_area) {
+				obs_log(LOG_INFO, "Frozen picture check alert! %.0f%% of the picture is frozen",
+					frame->static_area * 100.0f);
+				alert_player_queue(ALERT_FROZEN);
+			}
+		} else if (frame->timestamp - frame->content_changed_ts > 1000000ULL * filter->frozen_time) {
+			obs_log(LOG_INFO, "Frozen picture check alert!");
+			alert_player_queue(ALERT_FROZEN);
+		}
+	}
 
-		if (filter->audio_ts_check && audio_ts - filter->current_audio->timestamp == 0) {
+	if (due[CHECK_UNIFORM] && frame && filter->uniform_check && frame->uniform_since_ts &&
+	    frame->timestamp - frame->uniform_since_ts > 1000000ULL * filter->uniform_time) {
+		obs_log(LOG_INFO, "Black/uniform picture check alert! Luma %.1f", frame->luma_mean);
+		alert_player_queue(ALERT_UNIFORM);
+	}
+
+	if (due[CHECK_SILENCE] && filter->silence_check && state->audio_seen) {
+		uint64_t sound_ts = filter->silence_digital ? filter->audio_nonzero_ts : filter->audio_loud_ts;
+
+		// The audio thread may already be ahead of the records drained above
+		if (state->audio_ts > sound_ts && state->audio_ts - sound_ts > 1000000ULL * filter->silence_time) {
+			obs_log(LOG_INFO, "Audio silence check alert!");
+			alert_player_queue(ALERT_SILENCE);
+		}
+	}
+
+	if (due[CHECK_AUDIO_LOOP] && filter->audio_loop_check && state->audio_seen) {
+		uint64_t loop_since_ts = filter->audio_loop_since_ts;
+
+		if (loop_since_ts && state->audio_ts > loop_since_ts &&
+		    state->audio_ts - loop_since_ts > 1000000ULL * filter->audio_loop_time) {
+			obs_log(LOG_INFO, "Stuck audio buffer check alert!");
+			alert_player_queue(ALERT_AUDIO_LOOP);
+		}
+	}
+
+	if (due[CHECK_CONTINUITY]) {
+		uint64_t gaps = filter->audio_gaps;
+		uint64_t overlaps = filter->audio_overlaps;
+		uint64_t jitter_ns = filter->audio_jitter_ns;
+
+		if (filter->continuity_check && (gaps != state->audio_gaps || overlaps != state->audio_overlaps)) {
+			obs_log(LOG_INFO, "Audio continuity check alert! %llu new gaps, %llu new overlaps",
+				(unsigned long long)(gaps - state->audio_gaps),
+				(unsigned long long)(overlaps - state->audio_overlaps));
+			alert_player_queue(ALERT_AUDIO_CONTINUITY);
+		} else if (filter->continuity_check && filter->jitter_threshold &&
+			   jitter_ns > 1000000ULL * filter->jitter_threshold) {
+			obs_log(LOG_INFO, "Audio jitter check alert! %.2f ms", jitter_ns / 1000000.0);
+			alert_player_queue(ALERT_AUDIO_CONTINUITY);
+		}
+
+		state->audio_gaps = gaps;
+		state->audio_overlaps = overlaps;
+	}
+
+	if (due[CHECK_AUDIO_TS]) {
+		if (filter->audio_ts_check && state->audio_seen && state->new_packets == 0) {
 			obs_log(LOG_INFO, "Audio timestamp check alert!");
-			play_alert_sound();
+			alert_player_queue(ALERT_AUDIO_TS);
 		}
+		state->new_packets = 0;
+	}
 
+	if (due[CHECK_SOURCE_ENABLED]) {
 		bool current_visible = obs_source_active(filter->source);
 
-		if (!current_visible && prev_visible)
-			not_visible_since_ts = filter->current_frame->timestamp;
+		// On the checker clock, a hidden source may not be delivering frames to take timestamps from
+		if (!current_visible && state->prev_visible)
+			state->not_visible_since_ts = now;
 
 		if (filter->source_enabled_check && !current_visible &&
-		    filter->current_frame->timestamp - not_visible_since_ts >
-			    1000000000ULL * filter->source_enabled_time) {
+		    now - state->not_visible_since_ts > 1000000000ULL * filter->source_enabled_time) {
 			obs_log(LOG_INFO, "Source enabled check alert!");
-			play_alert_sound();
+			alert_player_queue(ALERT_SOURCE_ENABLED);
 		}
 
-		// TODO: Video/Audio Desync check
+		state->prev_visible = current_visible;
+	}
 
-		prev_visible = current_visible;
+	int64_t desync_ns;
+	uint32_t desync_epoch;
+
+	if (due[CHECK_DESYNC]) {
+		if (!av_sync_desync(&filter->video_sync, &filter->audio_sync, &desync_ns, &desync_epoch)) {
+			state->desync_learned = false;
+		} else if (!state->desync_learned || desync_epoch != state->desync_epoch) {
+			state->desync_baseline_ns = desync_ns;
+			state->desync_epoch = desync_epoch;
+			state->desync_learned = true;
+		} else {
+			int64_t drift_ns = desync_ns - state->desync_baseline_ns;
+			if (filter->desync_check && (uint64_t)llabs(drift_ns) > 1000000ULL * filter->desync_threshold) {
+				obs_log(LOG_INFO, "Video/Audio desync check alert! Video drifted %.1f ms %s audio",
+					llabs(drift_ns) / 1000000.0, drift_ns > 0 ? "behind" : "ahead of");
+				alert_player_queue(ALERT_DESYNC);
+			}
+		}
+	}
 
-		frame_ts = filter->current_frame->timestamp;
-		audio_ts = filter->current_audio->timestamp;
-		std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+	cadence_stats stats;
+
+	if (due[CHECK_CADENCE]) {
+		double tolerance = filter->cadence_tolerance / 100.0;
+
+		if (!cadence_get_stats(&filter->cadence, &stats)) {
+			state->cadence_fps = 0.0;
+			state->cadence_settling = false;
+		} else if (state->cadence_settling) {
+			// The average is still on its way while readings keep leaving the tolerance of the last one
+			if (fabs(stats.fps - state->cadence_settle_fps) > state->cadence_settle_fps * tolerance) {
+				state->cadence_settle_fps = stats.fps;
+				state->cadence_settle_ts = now;
+			} else if (now - state->cadence_settle_ts >= CADENCE_SETTLE_NS) {
+				state->cadence_fps = stats.fps;
+				state->cadence_settling = false;
+			}
+		} else if (state->cadence_fps == 0.0) {
+			// A fresh start seeds the average with the first interval, there is no transition to wait out
+			state->cadence_fps = stats.fps;
+		} else if (filter->cadence_check &&
+			   fabs(stats.fps - state->cadence_fps) > state->cadence_fps * tolerance) {
+			obs_log(LOG_INFO, "Frame rate check alert! %.2f fps, was %.2f fps", stats.fps, state->cadence_fps);
+			alert_player_queue(ALERT_CADENCE);
+			// Learn the new rate once the average has settled on it, rather than alerting on the way there
+			state->cadence_fps = 0.0;
+			state->cadence_settling = true;
+			state->cadence_settle_fps = stats.fps;
+			state->cadence_settle_ts = now;
+		} else if (filter->cadence_check && filter->stutter_threshold &&
+			   stats.jitter_ms > filter->stutter_threshold) {
+			obs_log(LOG_INFO, "Frame cadence check alert! %.2f ms jitter, %.1f%% of frames late",
+				stats.jitter_ms, stats.late * 100.0);
+			alert_player_queue(ALERT_CADENCE);
+		}
+	}
+
+	uint64_t next = state->next_check[0];
+	for (size_t i = 1; i < CHECK_COUNT; i++) {
+		if (state->next_check[i] < next)
+			next = state->next_check[i];
+	}
+
+	return next;
+}
+
+static void analyze_frame(struct capture_checker_data *filter, struct obs_source_frame *frame)
+{
+	// Freezes and uniform pictures only need to be seen a few times within their alert time, so most frames
+	// skip the analysis
+	uint64_t compare_interval = 1000000ULL * filter->frozen_time / 8;
+	uint64_t uniform_interval = 1000000ULL * filter->uniform_time / 8;
+
+	bool fingerprint = filter->frozen_mode == FROZEN_MODE_FINGERPRINT;
+	bool tiles = filter->frozen_mode == FROZEN_MODE_TILES;
+	bool perceptual = filter->frozen_mode == FROZEN_MODE_PERCEPTUAL;
+	bool reference_valid = filter->frame_cmp.valid;
+	if (tiles)
+		reference_valid = filter->tiles.valid;
+	else if (perceptual)
+		reference_valid = filter->phash.valid;
+	else if (fingerprint)
+		reference_valid = filter->frame_fp.valid;
+
+	bool compare_due = filter->frozen_check &&
+			   (!reference_valid || frame->timestamp - filter->last_compare_ts >= compare_interval);
+	bool uniform_due = filter->uniform_check && frame->timestamp - filter->last_uniform_ts >= uniform_interval;
+
+	if ((compare_due && (tiles || perceptual)) || uniform_due)
+		luma_pyramid_build(&filter->pyramid, frame);
+
+	if (compare_due) {
+		if (tiles) {
+			tile_map_update(&filter->tiles, &filter->pyramid, filter->tile_columns, filter->tile_rows);
+		} else {
+			bool changed;
+
+			if (perceptual)
+				changed = perceptual_hash_update(&filter->phash, &filter->pyramid, filter->phash_threshold);
+			else if (fingerprint)
+				changed = frame_fingerprint_update(&filter->frame_fp, frame, filter->fingerprint_samples);
+			else
+				changed = frame_compare_update(&filter->frame_cmp, frame);
+
+			if (changed)
+				filter->content_changed_ts = frame->timestamp;
+		}
+		filter->last_compare_ts = frame->timestamp;
+	}
+
+	if (uniform_due) {
+		filter->luma_valid = luma_pyramid_stats(&filter->pyramid, &filter->luma_mean, &filter->luma_variance);
+		filter->last_uniform_ts = frame->timestamp;
+
+		// The threshold is a standard deviation in 8-bit luma levels
+		float max_variance = (float)filter->uniform_threshold * filter->uniform_threshold;
+		if (!filter->luma_valid || filter->luma_variance > max_variance)
+			filter->uniform_since_ts = 0;
+		else if (!filter->uniform_since_ts)
+			filter->uniform_since_ts = frame->timestamp;
+	} else if (!filter->uniform_check) {
+		filter->luma_valid = false;
+		filter->uniform_since_ts = 0;
 	}
 }
 
@@ -258,11 +882,38 @@ static struct obs_source_frame *filter_video(void *data, struct obs_source_frame
 	if (filter->source == nullptr)
 		filter->source = obs_filter_get_parent(filter->context);
 
-	if (!filter->thread_active && obs_source_enabled(filter->context) && obs_source_active(filter->source))
-		start_thread(data);
-
-	if (filter->current_frame == nullptr || frame->timestamp != filter->current_frame->timestamp)
-		filter->current_frame = frame;
+	if (!filter->checker.active && obs_source_enabled(filter->context) && obs_source_active(filter->source))
+		start_checker(data);
+
+	analyze_frame(filter, frame);
+
+	uint64_t received_ns = checker_clock_now();
+
+	spsc_push(&filter->video_records, video_record{frame->timestamp});
+	av_sync_update(&filter->video_sync, frame->timestamp, received_ns);
+	cadence_update(&filter->cadence, frame->timestamp);
+
+	frame_snapshot *snapshot = snapshot_pool_back(&filter->frames);
+	snapshot->timestamp = frame->timestamp;
+	snapshot->format = frame->format;
+	snapshot->width = frame->width;
+	snapshot->height = frame->height;
+	snapshot->fingerprint = filter->frozen_mode == FROZEN_MODE_FINGERPRINT ? filter->frame_fp.next_hash : 0;
+	snapshot->content_changed_ts = filter->content_changed_ts;
+	snapshot->static_area = 0.0f;
+	if (filter->frozen_check && filter->frozen_mode == FROZEN_MODE_TILES)
+		snapshot->static_area =
+			tile_map_static_area(&filter->tiles, frame->timestamp, 1000000ULL * filter->frozen_time);
+	snapshot->luma_valid = filter->luma_valid;
+	snapshot->luma_mean = filter->luma_mean;
+	snapshot->luma_variance = filter->luma_variance;
+	snapshot->uniform_since_ts = filter->uniform_since_ts;
+	snapshot_pool_publish(&filter->frames);
+
+	// Wake the checker for the first frame, and well before the rings could overflow between checks
+	if ((filter->wants_media && filter->wants_media.exchange(false)) ||
+	    spsc_size(&filter->video_records) > VIDEO_RECORD_RING_SIZE / 2)
+		checker_scheduler_wake(&filter->checker);
 
 	return frame;
 }
@@ -271,7 +922,46 @@ static struct obs_audio_data *filter_audio(void *data, struct obs_audio_data *au
 {
 	struct capture_checker_data *filter = (capture_checker_data *)data;
 
-	filter->current_audio = audio;
+	// Audio-only sources never call filter_video, so the checker has to be started from here as well
+	if (filter->source == nullptr)
+		filter->source = obs_filter_get_parent(filter->context);
+
+	if (!filter->checker.active && obs_source_enabled(filter->context) && obs_source_active(filter->source))
+		start_checker(data);
+
+	audio_t *output = obs_get_audio();
+	size_t channels = audio_output_get_channels(output);
+	uint32_t sample_rate = audio_output_get_sample_rate(output);
+
+	audio_levels_update(&filter->levels, audio, channels, sample_rate, filter->silence_threshold);
+	filter->audio_loud_ts = filter->levels.loud_ts;
+	filter->audio_nonzero_ts = filter->levels.nonzero_ts;
+
+	if (filter->audio_loop_check)
+		audio_loop_update(&filter->loop, audio, channels, !filter->levels.last_nonzero);
+	else
+		filter->loop.loop_since_ts = 0;
+	filter->audio_loop_since_ts = filter->loop.loop_since_ts;
+
+	uint64_t tolerance_ns = 1000000ULL * filter->continuity_tolerance;
+	enum audio_continuity_result continuity =
+		audio_continuity_update(&filter->continuity, audio->timestamp, audio->frames, sample_rate, tolerance_ns);
+	filter->audio_gaps = filter->continuity.gaps;
+	filter->audio_overlaps = filter->continuity.overlaps;
+	filter->audio_jitter_ns = (uint64_t)filter->continuity.jitter_ns;
+
+	uint64_t received_ns = checker_clock_now();
+
+	spsc_push(&filter->audio_records, audio_record{audio->timestamp});
+	av_sync_update(&filter->audio_sync, audio->timestamp, received_ns);
+
+	bool discontinuity = filter->continuity_check && (continuity == AUDIO_GAP || continuity == AUDIO_OVERLAP);
+	if (discontinuity)
+		filter->continuity_event = true;
+
+	if ((filter->wants_media && filter->wants_media.exchange(false)) || discontinuity ||
+	    spsc_size(&filter->audio_records) > AUDIO_RECORD_RING_SIZE / 2)
+		checker_scheduler_wake(&filter->checker);
 
 	return audio;
 }
@@ -282,6 +972,42 @@ void filter_defaults(void *, obs_data_t *settings)
 	obs_data_set_default_bool(settings, SETTING_AUDIO_TS_CHECK, true);
 	obs_data_set_default_bool(settings, SETTING_SOURCE_ENABLED_CHECK, true);
 	obs_data_set_default_int(settings, SETTING_SOURCE_ENABLED_TIME, 5);
+	obs_data_set_default_bool(settings, SETTING_FROZEN_CHECK, false);
+	obs_data_set_default_int(settings, SETTING_FROZEN_TIME, 3000);
+	obs_data_set_default_int(settings, SETTING_FROZEN_MODE, FROZEN_MODE_FINGERPRINT);
+	obs_data_set_default_int(settings, SETTING_FINGERPRINT_SAMPLES, 1024);
+	obs_data_set_default_int(settings, SETTING_PHASH_THRESHOLD, 6);
+	obs_data_set_default_int(settings, SETTING_TILE_COLUMNS, 8);
+	obs_data_set_default_int(settings, SETTING_TILE_ROWS, 8);
+	obs_data_set_default_int(settings, SETTING_TILE_STATIC_AREA, 50);
+	obs_data_set_default_int(settings, SETTING_VIDEO_TS_INTERVAL, 1000);
+	obs_data_set_default_int(settings, SETTING_AUDIO_TS_INTERVAL, 1000);
+	obs_data_set_default_int(settings, SETTING_SOURCE_ENABLED_INTERVAL, 1000);
+	obs_data_set_default_int(settings, SETTING_FROZEN_INTERVAL, 250);
+	obs_data_set_default_bool(settings, SETTING_SILENCE_CHECK, false);
+	obs_data_set_default_int(settings, SETTING_SILENCE_TIME, 5000);
+	obs_data_set_default_int(settings, SETTING_SILENCE_THRESHOLD, -60);
+	obs_data_set_default_bool(settings, SETTING_SILENCE_DIGITAL, false);
+	obs_data_set_default_int(settings, SETTING_SILENCE_INTERVAL, 250);
+	obs_data_set_default_bool(settings, SETTING_AUDIO_LOOP_CHECK, false);
+	obs_data_set_default_int(settings, SETTING_AUDIO_LOOP_TIME, 1000);
+	obs_data_set_default_int(settings, SETTING_AUDIO_LOOP_INTERVAL, 250);
+	obs_data_set_default_bool(settings, SETTING_CONTINUITY_CHECK, false);
+	obs_data_set_default_int(settings, SETTING_CONTINUITY_TOLERANCE, 10);
+	obs_data_set_default_int(settings, SETTING_JITTER_THRESHOLD, 5);
+	obs_data_set_default_int(settings, SETTING_CONTINUITY_INTERVAL, 1000);
+	obs_data_set_default_bool(settings, SETTING_DESYNC_CHECK, false);
+	obs_data_set_default_int(settings, SETTING_DESYNC_THRESHOLD, 100);
+	obs_data_set_default_int(settings, SETTING_DESYNC_INTERVAL, 1000);
+	obs_data_set_default_bool(settings, SETTING_UNIFORM_CHECK, false);
+	obs_data_set_default_int(settings, SETTING_UNIFORM_TIME, 3000);
+	obs_data_set_default_int(settings, SETTING_UNIFORM_THRESHOLD, 2);
+	obs_data_set_default_int(settings, SETTING_UNIFORM_INTERVAL, 250);
+	obs_data_set_default_bool(settings, SETTING_CADENCE_CHECK, false);
+	obs_data_set_default_int(settings, SETTING_CADENCE_TOLERANCE, 10);
+	obs_data_set_default_int(settings, SETTING_STUTTER_THRESHOLD, 5);
+	obs_data_set_default_int(settings, SETTING_CADENCE_INTERVAL, 1000);
+	obs_data_set_default_int(settings, SETTING_SIMD_TIER, SIMD_TIER_AUTO);
 }
 
 bool obs_module_load(void)
@@ -300,11 +1026,21 @@ bool obs_module_load(void)
 	filter_info.filter_audio = filter_audio;
 
 	obs_register_source(&filter_info);
+	alert_player_register();
+	obs_frontend_add_event_callback(frontend_event, nullptr);
+	checker_scheduler_init();
+	alert_player_init();
+	simd_kernels_select(SIMD_TIER_AUTO);
+
 	obs_log(LOG_INFO, "plugin loaded successfully (version %s)", PLUGIN_VERSION);
 	return true;
 }
 
 void obs_module_unload(void)
 {
+	obs_frontend_remove_event_callback(frontend_event, nullptr);
+	checker_scheduler_free();
+	alert_player_free();
+
 	obs_log(LOG_INFO, "plugin unloaded");
 }
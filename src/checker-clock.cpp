@@ -0,0 +1,62 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "checker-clock.h"
+
+#include <util/platform.h>
+
+#include <atomic>
+
+static uint64_t system_now(void *)
+{
+	return os_gettime_ns();
+}
+
+static void system_wait(void *, os_event_t *event, uint64_t deadline)
+{
+	uint64_t now = os_gettime_ns();
+
+	if (deadline <= now)
+		return;
+
+	// Round up, waking a little late is fine but waking early would spin until the deadline
+	os_event_timedwait(event, (unsigned long)((deadline - now + 999999) / 1000000));
+}
+
+static const struct checker_clock system_clock = {system_now, system_wait, nullptr};
+
+static std::atomic<const struct checker_clock *> active_clock{&system_clock};
+
+void checker_clock_set(const struct checker_clock *clock)
+{
+	active_clock = clock ? clock : &system_clock;
+}
+
+uint64_t checker_clock_now(void)
+{
+	const struct checker_clock *clock = active_clock.load(std::memory_order_relaxed);
+
+	return clock->now(clock->param);
+}
+
+void checker_clock_wait(os_event_t *event, uint64_t deadline)
+{
+	const struct checker_clock *clock = active_clock.load(std::memory_order_relaxed);
+
+	clock->wait(clock->param, event, deadline);
+}
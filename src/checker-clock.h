@@ -0,0 +1,39 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <util/threading.h>
+
+#include <stdint.h>
+
+// Where the checker gets its time and does its waiting. Unless one is installed it is os_gettime_ns, with
+// waits that end early when the event is signalled.
+struct checker_clock {
+	uint64_t (*now)(void *param);
+	// Blocks until deadline on this clock, or until event is signalled, whichever comes first
+	void (*wait)(void *param, os_event_t *event, uint64_t deadline);
+	void *param;
+};
+
+// Only while no checker scheduler is running: before obs_module_load or after obs_module_unload.
+// The clock has to outlive its use, nullptr goes back to the system clock.
+void checker_clock_set(const struct checker_clock *clock);
+
+uint64_t checker_clock_now(void);
+void checker_clock_wait(os_event_t *event, uint64_t deadline);
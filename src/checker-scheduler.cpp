@@ -0,0 +1,171 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "checker-scheduler.h"
+#include "checker-clock.h"
+
+#include <obs-module.h>
+#include <plugin-support.h>
+#include <util/threading.h>
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Longest the scheduler sleeps when nothing is due
+#define SCHEDULER_IDLE_MS 1000
+
+struct scheduler_item {
+	uint64_t deadline;
+	scheduler_entry *entry;
+	uint64_t seq;
+};
+
+// Min-heap ordering for the std heap functions
+static bool item_later(const scheduler_item &a, const scheduler_item &b)
+{
+	return a.deadline > b.deadline;
+}
+
+static std::mutex scheduler_mutex;
+static std::vector<scheduler_entry *> scheduler_entries;
+static std::vector<scheduler_item> scheduler_heap;
+static std::thread scheduler_thread;
+static std::atomic<bool> scheduler_running{false};
+static os_event_t *scheduler_event = nullptr;
+// Guards the lifetime of scheduler_event, kept apart from scheduler_mutex so wakes from the media threads
+// never wait for a running check
+static std::mutex scheduler_event_mutex;
+
+static void schedule_locked(scheduler_entry *entry, uint64_t deadline)
+{
+	scheduler_heap.push_back(scheduler_item{deadline, entry, ++entry->seq});
+	std::push_heap(scheduler_heap.begin(), scheduler_heap.end(), item_later);
+}
+
+static void scheduler_loop()
+{
+	std::unique_lock<std::mutex> lock(scheduler_mutex);
+
+	while (scheduler_running) {
+		for (scheduler_entry *entry : scheduler_entries) {
+			if (entry->wake_pending.exchange(false) && entry->active)
+				schedule_locked(entry, 0);
+		}
+
+		uint64_t now = checker_clock_now();
+
+		while (!scheduler_heap.empty() && scheduler_heap.front().deadline <= now) {
+			std::pop_heap(scheduler_heap.begin(), scheduler_heap.end(), item_later);
+			scheduler_item item = scheduler_heap.back();
+			scheduler_heap.pop_back();
+
+			// Superseded by a newer item, or the filter was disabled
+			if (item.seq != item.entry->seq || !item.entry->active)
+				continue;
+
+			schedule_locked(item.entry, item.entry->run(item.entry->data, now));
+			now = checker_clock_now();
+		}
+
+		uint64_t deadline = now + 1000000ULL * SCHEDULER_IDLE_MS;
+		if (!scheduler_heap.empty() && scheduler_heap.front().deadline < deadline)
+			deadline = scheduler_heap.front().deadline;
+
+		lock.unlock();
+		checker_clock_wait(scheduler_event, deadline);
+		lock.lock();
+	}
+}
+
+void checker_scheduler_init(void)
+{
+	if (scheduler_running)
+		return;
+
+	if (!scheduler_event)
+		os_event_init(&scheduler_event, OS_EVENT_TYPE_AUTO);
+	scheduler_running = true;
+	scheduler_thread = std::thread(scheduler_loop);
+}
+
+void checker_scheduler_stop(void)
+{
+	if (!scheduler_running.exchange(false))
+		return;
+
+	os_event_signal(scheduler_event);
+	scheduler_thread.join();
+
+	obs_log(LOG_INFO, "Checker scheduler stopped");
+}
+
+void checker_scheduler_free(void)
+{
+	checker_scheduler_stop();
+
+	std::lock_guard<std::mutex> lock(scheduler_event_mutex);
+	os_event_destroy(scheduler_event);
+	scheduler_event = nullptr;
+}
+
+void checker_scheduler_register(scheduler_entry *entry, scheduler_run_t run, void *data)
+{
+	std::lock_guard<std::mutex> lock(scheduler_mutex);
+
+	entry->run = run;
+	entry->data = data;
+	scheduler_entries.push_back(entry);
+}
+
+void checker_scheduler_unregister(scheduler_entry *entry)
+{
+	std::lock_guard<std::mutex> lock(scheduler_mutex);
+
+	entry->active = false;
+	scheduler_entries.erase(std::remove(scheduler_entries.begin(), scheduler_entries.end(), entry),
+				scheduler_entries.end());
+	scheduler_heap.erase(std::remove_if(scheduler_heap.begin(), scheduler_heap.end(),
+					    [entry](const scheduler_item &item) { return item.entry == entry; }),
+			     scheduler_heap.end());
+	std::make_heap(scheduler_heap.begin(), scheduler_heap.end(), item_later);
+}
+
+void checker_scheduler_wake(scheduler_entry *entry)
+{
+	entry->wake_pending = true;
+
+	// A late media callback can race checker_scheduler_free, the event is only destroyed under this lock
+	std::lock_guard<std::mutex> lock(scheduler_event_mutex);
+	if (scheduler_running && scheduler_event)
+		os_event_signal(scheduler_event);
+}
+
+void checker_scheduler_activate(scheduler_entry *entry)
+{
+	if (entry->active.exchange(true))
+		return;
+
+	checker_scheduler_wake(entry);
+}
+
+void checker_scheduler_deactivate(scheduler_entry *entry)
+{
+	entry->active = false;
+}
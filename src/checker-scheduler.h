@@ -0,0 +1,55 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+
+// Runs the checks of the entry and returns when it wants to run next, both on the checker clock.
+typedef uint64_t (*scheduler_run_t)(void *data, uint64_t now);
+
+// One per filter, owned by the filter. Only active and wake_pending are touched outside the scheduler lock.
+struct scheduler_entry {
+	scheduler_run_t run;
+	void *data;
+
+	std::atomic<bool> active;
+	std::atomic<bool> wake_pending;
+
+	// Matches the heap item that is currently valid for this entry
+	uint64_t seq;
+};
+
+// The module wide scheduler thread, started in obs_module_load and freed in obs_module_unload.
+// checker_scheduler_stop only ends the thread, so filters can still call in while the frontend shuts down.
+void checker_scheduler_init(void);
+void checker_scheduler_stop(void);
+void checker_scheduler_free(void);
+
+// Registration takes the scheduler lock, so after checker_scheduler_unregister returns the entry is
+// not running and never will again.
+void checker_scheduler_register(scheduler_entry *entry, scheduler_run_t run, void *data);
+void checker_scheduler_unregister(scheduler_entry *entry);
+
+// Safe from the OBS video and audio threads, also after checker_scheduler_free. These never take the scheduler
+// lock, but waking the thread briefly takes the lock guarding the scheduler event and the event's own mutex.
+void checker_scheduler_activate(scheduler_entry *entry);
+void checker_scheduler_deactivate(scheduler_entry *entry);
+void checker_scheduler_wake(scheduler_entry *entry);
@@ -0,0 +1,58 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "frame-snapshot.h"
+
+#define SNAPSHOT_FRESH 0x80
+#define SNAPSHOT_INDEX 0x7F
+
+void snapshot_pool_init(snapshot_pool *pool)
+{
+	pool->back = 0;
+	pool->middle.store(1, std::memory_order_relaxed);
+	pool->front = 2;
+	pool->has_front = false;
+}
+
+frame_snapshot *snapshot_pool_back(snapshot_pool *pool)
+{
+	return &pool->slots[pool->back];
+}
+
+void snapshot_pool_publish(snapshot_pool *pool)
+{
+	uint8_t prev = pool->middle.exchange(pool->back | SNAPSHOT_FRESH, std::memory_order_acq_rel);
+	pool->back = prev & SNAPSHOT_INDEX;
+}
+
+const frame_snapshot *snapshot_pool_acquire(snapshot_pool *pool)
+{
+	if (pool->middle.load(std::memory_order_relaxed) & SNAPSHOT_FRESH) {
+		uint8_t prev = pool->middle.exchange(pool->front, std::memory_order_acq_rel);
+		pool->front = prev & SNAPSHOT_INDEX;
+		pool->has_front = true;
+	}
+
+	return pool->has_front ? &pool->slots[pool->front] : nullptr;
+}
+
+void snapshot_pool_reset_reader(snapshot_pool *pool)
+{
+	pool->middle.fetch_and(SNAPSHOT_INDEX, std::memory_order_acq_rel);
+	pool->has_front = false;
+}
@@ -0,0 +1,67 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs-module.h>
+
+#include <atomic>
+
+// The parts of an obs_source_frame the checker needs after filter_video has returned the frame to OBS.
+struct frame_snapshot {
+	uint64_t timestamp;
+	enum video_format format;
+	uint32_t width;
+	uint32_t height;
+
+	uint64_t fingerprint;
+	uint64_t content_changed_ts;
+	// Share of the picture that has been static for the frozen time, in tile mode
+	float static_area;
+
+	bool luma_valid;
+	float luma_mean;
+	float luma_variance;
+	// First frame of the current run of near-uniform frames, 0 when the picture has detail
+	uint64_t uniform_since_ts;
+};
+
+#define SNAPSHOT_SLOTS 3
+
+// Triple buffer: the video thread always owns one slot, the checker thread owns another and the third
+// is handed over with a single atomic exchange. Neither side ever waits or allocates.
+struct snapshot_pool {
+	frame_snapshot slots[SNAPSHOT_SLOTS];
+	std::atomic<uint8_t> middle;
+	uint8_t back;
+	uint8_t front;
+	bool has_front;
+};
+
+void snapshot_pool_init(snapshot_pool *pool);
+
+// Producer side: fill the slot returned by snapshot_pool_back and publish it.
+frame_snapshot *snapshot_pool_back(snapshot_pool *pool);
+void snapshot_pool_publish(snapshot_pool *pool);
+
+// Consumer side: returns the newest published snapshot, or the previous one if nothing new was published.
+// The pointer stays valid until the next acquire. Returns nullptr until the first publish.
+const frame_snapshot *snapshot_pool_acquire(snapshot_pool *pool);
+
+// Consumer side: forget everything published so far.
+void snapshot_pool_reset_reader(snapshot_pool *pool);
@@ -0,0 +1,281 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "luma-pyramid.h"
+#include "hash.h"
+#include "simd-kernels.h"
+
+#include <string.h>
+
+#define COARSE_FACTOR (PYRAMID_COARSE_SCALE / PYRAMID_FINE_SCALE)
+
+enum luma_reader_kind {
+	LUMA_NONE,
+	LUMA_U8,
+	LUMA_U16,
+	LUMA_RGB32,
+	LUMA_BGR24,
+	LUMA_R10L,
+	LUMA_V210,
+};
+
+// Where the luma (or the RGB it's derived from) sits in the first plane of a format
+struct luma_reader {
+	enum luma_reader_kind kind;
+	uint32_t step;
+	uint32_t offset;
+	unsigned shift;
+	bool bgr;
+};
+
+static constexpr luma_reader get_luma_reader(enum video_format format)
+{
+	switch (format) {
+	case VIDEO_FORMAT_I420:
+	case VIDEO_FORMAT_NV12:
+	case VIDEO_FORMAT_I422:
+	case VIDEO_FORMAT_I444:
+	case VIDEO_FORMAT_I40A:
+	case VIDEO_FORMAT_I42A:
+	case VIDEO_FORMAT_YUVA:
+	case VIDEO_FORMAT_Y800:
+		return {LUMA_U8, 1, 0, 0, false};
+	case VIDEO_FORMAT_YUY2:
+	case VIDEO_FORMAT_YVYU:
+		return {LUMA_U8, 2, 0, 0, false};
+	case VIDEO_FORMAT_UYVY:
+		return {LUMA_U8, 2, 1, 0, false};
+	case VIDEO_FORMAT_AYUV:
+		// Stored V, U, Y, A
+		return {LUMA_U8, 4, 2, 0, false};
+	case VIDEO_FORMAT_I010:
+	case VIDEO_FORMAT_I210:
+		return {LUMA_U16, 2, 0, 2, false};
+	case VIDEO_FORMAT_I412:
+	case VIDEO_FORMAT_YA2L:
+		return {LUMA_U16, 2, 0, 4, false};
+	case VIDEO_FORMAT_P010:
+	case VIDEO_FORMAT_P216:
+	case VIDEO_FORMAT_P416:
+		return {LUMA_U16, 2, 0, 8, false};
+	case VIDEO_FORMAT_RGBA:
+		return {LUMA_RGB32, 4, 0, 0, false};
+	case VIDEO_FORMAT_BGRA:
+	case VIDEO_FORMAT_BGRX:
+		return {LUMA_RGB32, 4, 0, 0, true};
+	case VIDEO_FORMAT_BGR3:
+		return {LUMA_BGR24, 3, 0, 0, true};
+	case VIDEO_FORMAT_R10L:
+		return {LUMA_R10L, 4, 0, 0, false};
+	case VIDEO_FORMAT_V210:
+		return {LUMA_V210, 0, 0, 0, false};
+	default:
+		return {LUMA_NONE, 0, 0, 0, false};
+	}
+}
+
+static inline uint8_t rgb_luma(uint32_t r, uint32_t g, uint32_t b)
+{
+	return (uint8_t)((r * LUMA_WEIGHT_R + g * LUMA_WEIGHT_G + b * LUMA_WEIGHT_B + 128) >> 8);
+}
+
+// Position of each of the 6 luma values in a 4-word v210 block, as word index and bit shift
+static const uint8_t v210_luma[6][2] = {{0, 10}, {1, 0}, {1, 20}, {2, 10}, {3, 0}, {3, 20}};
+
+// Returns the first count luma values of the row, either in place or extracted into scratch. Everything
+// about the format is a compile-time constant here, so no loop checks the format.
+template<enum video_format Format>
+static const uint8_t *extract_row(const uint8_t *src, uint32_t count, uint8_t *scratch)
+{
+	constexpr luma_reader reader = get_luma_reader(Format);
+
+	if constexpr (reader.kind == LUMA_U8 && reader.step == 1) {
+		return src;
+	} else if constexpr (reader.kind == LUMA_U8) {
+		simd_extract_luma_u8(src, count, reader.step, reader.offset, scratch);
+	} else if constexpr (reader.kind == LUMA_U16) {
+		simd_extract_luma_u16((const uint16_t *)src, count, reader.shift, scratch);
+	} else if constexpr (reader.kind == LUMA_RGB32) {
+		simd_extract_luma_rgb32(src, count, reader.bgr, scratch);
+	} else if constexpr (reader.kind == LUMA_BGR24) {
+		for (uint32_t i = 0; i < count; i++, src += 3)
+			scratch[i] = rgb_luma(src[2], src[1], src[0]);
+	} else if constexpr (reader.kind == LUMA_R10L) {
+		// Little-endian words of 10-bit R, G and B from the top, 2 bits of padding
+		for (uint32_t i = 0; i < count; i++, src += 4) {
+			uint32_t w = load32(src);
+			scratch[i] = rgb_luma(w >> 24, (w >> 14) & 0xFF, (w >> 4) & 0xFF);
+		}
+	} else if constexpr (reader.kind == LUMA_V210) {
+		uint32_t i = 0;
+		for (; i + 6 <= count; i += 6, src += 16)
+			for (uint32_t j = 0; j < 6; j++)
+				scratch[i + j] = (uint8_t)(load32(src + v210_luma[j][0] * 4) >> (v210_luma[j][1] + 2));
+		for (uint32_t j = 0; i < count; i++, j++)
+			scratch[i] = (uint8_t)(load32(src + v210_luma[j][0] * 4) >> (v210_luma[j][1] + 2));
+	}
+
+	return scratch;
+}
+
+// Columns and rows past the last whole cell are left out
+template<enum video_format Format> static void build_fine(luma_pyramid *pyramid, const struct obs_source_frame *frame)
+{
+	luma_image *fine = &pyramid->fine;
+	uint32_t count = fine->width * PYRAMID_FINE_SCALE;
+
+	for (uint32_t y = 0; y < fine->height; y++) {
+		memset(pyramid->sums, 0, fine->width * sizeof(uint16_t));
+
+		for (uint32_t i = 0; i < PYRAMID_FINE_SCALE; i++) {
+			const uint8_t *src = frame->data[0] + (size_t)(y * PYRAMID_FINE_SCALE + i) * frame->linesize[0];
+			simd_box8_accumulate(extract_row<Format>(src, count, pyramid->row), fine->width, pyramid->sums);
+		}
+
+		uint8_t *dst = fine->data + (size_t)y * fine->width;
+		for (uint32_t x = 0; x < fine->width; x++)
+			dst[x] = (uint8_t)((pyramid->sums[x] + 32) >> 6);
+	}
+}
+
+#define BUILDER(format)     \
+	case format:        \
+		return build_fine<format>
+
+static luma_pyramid_build_fn select_builder(enum video_format format)
+{
+	switch (format) {
+		BUILDER(VIDEO_FORMAT_I420);
+		BUILDER(VIDEO_FORMAT_NV12);
+		BUILDER(VIDEO_FORMAT_YVYU);
+		BUILDER(VIDEO_FORMAT_YUY2);
+		BUILDER(VIDEO_FORMAT_UYVY);
+		BUILDER(VIDEO_FORMAT_RGBA);
+		BUILDER(VIDEO_FORMAT_BGRA);
+		BUILDER(VIDEO_FORMAT_BGRX);
+		BUILDER(VIDEO_FORMAT_Y800);
+		BUILDER(VIDEO_FORMAT_I444);
+		BUILDER(VIDEO_FORMAT_BGR3);
+		BUILDER(VIDEO_FORMAT_I422);
+		BUILDER(VIDEO_FORMAT_I40A);
+		BUILDER(VIDEO_FORMAT_I42A);
+		BUILDER(VIDEO_FORMAT_YUVA);
+		BUILDER(VIDEO_FORMAT_AYUV);
+		BUILDER(VIDEO_FORMAT_I010);
+		BUILDER(VIDEO_FORMAT_P010);
+		BUILDER(VIDEO_FORMAT_I210);
+		BUILDER(VIDEO_FORMAT_I412);
+		BUILDER(VIDEO_FORMAT_YA2L);
+		BUILDER(VIDEO_FORMAT_P216);
+		BUILDER(VIDEO_FORMAT_P416);
+		BUILDER(VIDEO_FORMAT_V210);
+		BUILDER(VIDEO_FORMAT_R10L);
+	default:
+		return nullptr;
+	}
+}
+
+#undef BUILDER
+
+static void resize(luma_pyramid *pyramid, uint32_t width, uint32_t height)
+{
+	pyramid->width = width;
+	pyramid->height = height;
+	pyramid->fine.width = width / PYRAMID_FINE_SCALE;
+	pyramid->fine.height = height / PYRAMID_FINE_SCALE;
+	pyramid->coarse.width = width / PYRAMID_COARSE_SCALE;
+	pyramid->coarse.height = height / PYRAMID_COARSE_SCALE;
+
+	bfree(pyramid->fine.data);
+	bfree(pyramid->coarse.data);
+	bfree(pyramid->row);
+	bfree(pyramid->sums);
+
+	pyramid->fine.data = (uint8_t *)bmalloc((size_t)pyramid->fine.width * pyramid->fine.height);
+	pyramid->coarse.data = (uint8_t *)bmalloc((size_t)pyramid->coarse.width * pyramid->coarse.height);
+	pyramid->row = (uint8_t *)bmalloc(width);
+	pyramid->sums = (uint16_t *)bmalloc(pyramid->fine.width * sizeof(uint16_t));
+}
+
+bool luma_pyramid_build(luma_pyramid *pyramid, const struct obs_source_frame *frame)
+{
+	pyramid->valid = false;
+
+	// The only format switch; the builder stays cached while the source keeps its format
+	if (frame->format != pyramid->format || !pyramid->build) {
+		pyramid->format = frame->format;
+		pyramid->build = select_builder(frame->format);
+	}
+
+	if (!pyramid->build || !frame->data[0] || frame->width < PYRAMID_COARSE_SCALE ||
+	    frame->height < PYRAMID_COARSE_SCALE)
+		return false;
+
+	if (pyramid->width != frame->width || pyramid->height != frame->height || !pyramid->fine.data)
+		resize(pyramid, frame->width, frame->height);
+
+	pyramid->build(pyramid, frame);
+
+	const luma_image *fine = &pyramid->fine;
+	luma_image *coarse = &pyramid->coarse;
+
+	for (uint32_t y = 0; y < coarse->height; y++) {
+		for (uint32_t x = 0; x < coarse->width; x++) {
+			const uint8_t *src = fine->data + (size_t)y * COARSE_FACTOR * fine->width + x * COARSE_FACTOR;
+			uint32_t sum = 0;
+
+			for (uint32_t i = 0; i < COARSE_FACTOR; i++, src += fine->width)
+				for (uint32_t j = 0; j < COARSE_FACTOR; j++)
+					sum += src[j];
+
+			coarse->data[(size_t)y * coarse->width + x] =
+				(uint8_t)((sum + COARSE_FACTOR * COARSE_FACTOR / 2) / (COARSE_FACTOR * COARSE_FACTOR));
+		}
+	}
+
+	pyramid->timestamp = frame->timestamp;
+	pyramid->valid = true;
+	return true;
+}
+
+void luma_pyramid_free(luma_pyramid *pyramid)
+{
+	bfree(pyramid->fine.data);
+	bfree(pyramid->coarse.data);
+	bfree(pyramid->row);
+	bfree(pyramid->sums);
+	*pyramid = {};
+}
+
+bool luma_pyramid_stats(const luma_pyramid *pyramid, float *mean, float *variance)
+{
+	if (!pyramid->valid)
+		return false;
+
+	size_t count = (size_t)pyramid->fine.width * pyramid->fine.height;
+	uint64_t sum = 0;
+	uint64_t sum_sq = 0;
+
+	simd_luma_sums_u8(pyramid->fine.data, count, 1, 0, &sum, &sum_sq);
+
+	double m = (double)sum / count;
+
+	*mean = (float)m;
+	*variance = (float)((double)sum_sq / count - m * m);
+	return true;
+}
@@ -0,0 +1,65 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs-module.h>
+
+#define PYRAMID_FINE_SCALE 8
+#define PYRAMID_COARSE_SCALE 32
+
+// Tightly packed 8-bit luma image
+struct luma_image {
+	uint8_t *data;
+	uint32_t width;
+	uint32_t height;
+};
+
+struct luma_pyramid;
+
+// Fills the fine level, specialized for one video_format
+typedef void (*luma_pyramid_build_fn)(struct luma_pyramid *pyramid, const struct obs_source_frame *frame);
+
+// Box-filtered luma thumbnails of a frame at 1/8 and 1/32 scale, built in one pass over the first plane so
+// the content checks don't each walk the full-resolution frame. The buffers are only reallocated when the
+// frame size changes.
+struct luma_pyramid {
+	enum video_format format;
+	luma_pyramid_build_fn build;
+
+	uint32_t width;
+	uint32_t height;
+
+	luma_image fine;
+	luma_image coarse;
+
+	// Scratch: one source row of extracted luma, and the fine-level column sums of the current band of rows
+	uint8_t *row;
+	uint16_t *sums;
+
+	uint64_t timestamp;
+	bool valid;
+};
+
+// RGB formats use BT.709 luma, deeper formats are brought down to 8 bits. Returns false (and leaves the
+// pyramid invalid) for formats we can't read luma from, or frames smaller than one coarse cell.
+bool luma_pyramid_build(luma_pyramid *pyramid, const struct obs_source_frame *frame);
+void luma_pyramid_free(luma_pyramid *pyramid);
+
+// Mean and variance of the fine level.
+bool luma_pyramid_stats(const luma_pyramid *pyramid, float *mean, float *variance);
@@ -0,0 +1,38 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "spsc-ring.h"
+
+// Timing of one frame seen by filter_video
+struct video_record {
+	uint64_t timestamp;
+};
+
+// Timing of one packet seen by filter_audio
+struct audio_record {
+	uint64_t timestamp;
+};
+
+// Room for a few seconds of 60 fps video and 48 kHz audio in 1024 sample packets
+#define VIDEO_RECORD_RING_SIZE 256
+#define AUDIO_RECORD_RING_SIZE 256
+
+typedef spsc_ring<video_record, VIDEO_RECORD_RING_SIZE> video_record_ring;
+typedef spsc_ring<audio_record, AUDIO_RECORD_RING_SIZE> audio_record_ring;
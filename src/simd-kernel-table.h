@@ -0,0 +1,68 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include "simd-kernels.h"
+
+// One set of kernels built for a single instruction set. simd-kernels.cpp picks the table at runtime; the
+// public simd_* functions call through it.
+struct simd_kernel_table {
+	bool (*bytes_equal)(const uint8_t *a, const uint8_t *b, size_t size);
+	void (*audio_levels)(const float *samples, size_t count, float *sum_sq, float *peak, bool *all_zero);
+	void (*luma_sums_u8)(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint64_t *sum,
+			     uint64_t *sum_sq);
+	void (*extract_luma_u8)(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint8_t *luma);
+	void (*extract_luma_u16)(const uint16_t *samples, size_t count, unsigned shift, uint8_t *luma);
+	void (*extract_luma_rgb32)(const uint8_t *pixels, size_t count, bool bgr, uint8_t *luma);
+	void (*box8_accumulate)(const uint8_t *row, size_t groups, uint16_t *sums);
+	uint8_t (*max_abs_diff)(const uint8_t *a, const uint8_t *b, size_t count);
+};
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_KERNELS_X86
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SIMD_KERNELS_ARM64
+#endif
+
+extern const struct simd_kernel_table simd_scalar_kernels;
+#if defined(SIMD_KERNELS_X86)
+extern const struct simd_kernel_table simd_sse2_kernels;
+extern const struct simd_kernel_table simd_avx2_kernels;
+#elif defined(SIMD_KERNELS_ARM64)
+extern const struct simd_kernel_table simd_neon_kernels;
+#endif
+
+// The vector kernels finish their tails with these.
+bool scalar_bytes_equal(const uint8_t *a, const uint8_t *b, size_t size);
+void scalar_luma_sums_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint64_t *sum,
+			 uint64_t *sum_sq);
+void scalar_extract_luma_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint8_t *luma);
+void scalar_extract_luma_u16(const uint16_t *samples, size_t count, unsigned shift, uint8_t *luma);
+void scalar_extract_luma_rgb32(const uint8_t *pixels, size_t count, bool bgr, uint8_t *luma);
+void scalar_box8_accumulate(const uint8_t *row, size_t groups, uint16_t *sums);
+uint8_t scalar_max_abs_diff(const uint8_t *a, const uint8_t *b, size_t count);
+
+#if defined(SIMD_KERNELS_X86)
+// The AVX2 table reuses the SSE2 kernels that gain nothing from wider registers.
+void sse2_luma_sums_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint64_t *sum,
+		       uint64_t *sum_sq);
+void sse2_extract_luma_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint8_t *luma);
+void sse2_extract_luma_u16(const uint16_t *samples, size_t count, unsigned shift, uint8_t *luma);
+void sse2_extract_luma_rgb32(const uint8_t *pixels, size_t count, bool bgr, uint8_t *luma);
+#endif
@@ -0,0 +1,178 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "simd-kernel-table.h"
+
+#if defined(SIMD_KERNELS_X86)
+
+#include <immintrin.h>
+#include <math.h>
+
+// Built without -mavx2 so that the rest of the plugin still runs on SSE2-only CPUs. GCC and Clang enable the
+// instruction set per function; MSVC accepts AVX2 intrinsics anywhere.
+#if defined(__GNUC__)
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+
+// Differences are accumulated over this many bytes before branching
+#define COMPARE_BLOCK 128
+
+AVX2_TARGET static bool avx2_bytes_equal(const uint8_t *a, const uint8_t *b, size_t size)
+{
+	size_t i = 0;
+
+	for (; i + COMPARE_BLOCK <= size; i += COMPARE_BLOCK) {
+		__m256i acc = _mm256_setzero_si256();
+		for (size_t j = 0; j < COMPARE_BLOCK; j += 32) {
+			__m256i va = _mm256_loadu_si256((const __m256i *)(a + i + j));
+			__m256i vb = _mm256_loadu_si256((const __m256i *)(b + i + j));
+			acc = _mm256_or_si256(acc, _mm256_xor_si256(va, vb));
+		}
+		if (!_mm256_testz_si256(acc, acc))
+			return false;
+	}
+
+	return scalar_bytes_equal(a + i, b + i, size - i);
+}
+
+AVX2_TARGET static void avx2_audio_levels(const float *samples, size_t count, float *sum_sq, float *peak,
+					  bool *all_zero)
+{
+	const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+	__m256 vsum = _mm256_setzero_ps();
+	__m256 vmax = _mm256_setzero_ps();
+	size_t i = 0;
+	float sum = 0.0f;
+	float max = 0.0f;
+
+	for (; i + 8 <= count; i += 8) {
+		__m256 v = _mm256_loadu_ps(samples + i);
+		vsum = _mm256_add_ps(vsum, _mm256_mul_ps(v, v));
+		vmax = _mm256_max_ps(vmax, _mm256_and_ps(v, abs_mask));
+	}
+
+	float lanes_sum[8], lanes_max[8];
+	_mm256_storeu_ps(lanes_sum, vsum);
+	_mm256_storeu_ps(lanes_max, vmax);
+	for (size_t j = 0; j < 8; j++) {
+		sum += lanes_sum[j];
+		max = lanes_max[j] > max ? lanes_max[j] : max;
+	}
+
+	for (; i < count; i++) {
+		float a = fabsf(samples[i]);
+		sum += samples[i] * samples[i];
+		max = a > max ? a : max;
+	}
+
+	*sum_sq = sum;
+	*peak = max;
+	// Only a packet of exact +0.0/-0.0 samples has a zero peak
+	*all_zero = max == 0.0f;
+}
+
+AVX2_TARGET static void avx2_luma_sums_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset,
+					  uint64_t *sum, uint64_t *sum_sq)
+{
+	// Interleaved luma does not shuffle any faster in 256-bit lanes
+	if (step != 1) {
+		sse2_luma_sums_u8(pixels, count, step, offset, sum, sum_sq);
+		return;
+	}
+
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i vsum = zero;
+	__m256i vsum_sq = zero;
+	size_t i = 0;
+
+	for (; i + 32 <= count; i += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)(pixels + i));
+		__m256i lo = _mm256_unpacklo_epi8(v, zero);
+		__m256i hi = _mm256_unpackhi_epi8(v, zero);
+		__m256i sq = _mm256_add_epi32(_mm256_madd_epi16(lo, lo), _mm256_madd_epi16(hi, hi));
+
+		vsum = _mm256_add_epi64(vsum, _mm256_sad_epu8(v, zero));
+		vsum_sq = _mm256_add_epi64(vsum_sq, _mm256_unpacklo_epi32(sq, zero));
+		vsum_sq = _mm256_add_epi64(vsum_sq, _mm256_unpackhi_epi32(sq, zero));
+	}
+
+	uint64_t lanes[4];
+	_mm256_storeu_si256((__m256i *)lanes, vsum);
+	*sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+	_mm256_storeu_si256((__m256i *)lanes, vsum_sq);
+	*sum_sq += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+	sse2_luma_sums_u8(pixels + i, count - i, 1, 0, sum, sum_sq);
+}
+
+AVX2_TARGET static void avx2_box8_accumulate(const uint8_t *row, size_t groups, uint16_t *sums)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	// The packs work within 128-bit halves and leave the 16 sums as dword pairs 0 2 4 6 1 3 5 7
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	size_t g = 0;
+
+	for (; g + 16 <= groups; g += 16) {
+		__m256i s0 = _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *)(row + g * 8)), zero);
+		__m256i s1 = _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *)(row + g * 8 + 32)), zero);
+		__m256i s2 = _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *)(row + g * 8 + 64)), zero);
+		__m256i s3 = _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *)(row + g * 8 + 96)), zero);
+		__m256i packed = _mm256_packs_epi32(_mm256_packs_epi32(s0, s1), _mm256_packs_epi32(s2, s3));
+		packed = _mm256_permutevar8x32_epi32(packed, order);
+
+		__m256i acc = _mm256_loadu_si256((const __m256i *)(sums + g));
+		_mm256_storeu_si256((__m256i *)(sums + g), _mm256_add_epi16(acc, packed));
+	}
+
+	scalar_box8_accumulate(row + g * 8, groups - g, sums + g);
+}
+
+AVX2_TARGET static uint8_t avx2_max_abs_diff(const uint8_t *a, const uint8_t *b, size_t count)
+{
+	__m256i vmax = _mm256_setzero_si256();
+	size_t i = 0;
+
+	for (; i + 32 <= count; i += 32) {
+		__m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+		__m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+		vmax = _mm256_max_epu8(vmax, _mm256_or_si256(_mm256_subs_epu8(va, vb), _mm256_subs_epu8(vb, va)));
+	}
+
+	uint8_t max = scalar_max_abs_diff(a + i, b + i, count - i);
+	uint8_t lanes[32];
+	_mm256_storeu_si256((__m256i *)lanes, vmax);
+	for (size_t j = 0; j < 32; j++)
+		max = lanes[j] > max ? lanes[j] : max;
+
+	return max;
+}
+
+const struct simd_kernel_table simd_avx2_kernels = {
+	avx2_bytes_equal,
+	avx2_audio_levels,
+	avx2_luma_sums_u8,
+	sse2_extract_luma_u8,
+	sse2_extract_luma_u16,
+	sse2_extract_luma_rgb32,
+	avx2_box8_accumulate,
+	avx2_max_abs_diff,
+};
+
+#endif
@@ -0,0 +1,222 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "simd-kernel-table.h"
+
+#if defined(SIMD_KERNELS_ARM64)
+
+#include <arm_neon.h>
+#include <math.h>
+
+// Advanced SIMD is mandatory on AArch64, so this tier is always available there
+
+// Differences are accumulated over this many bytes before branching
+#define COMPARE_BLOCK 128
+
+static bool neon_bytes_equal(const uint8_t *a, const uint8_t *b, size_t size)
+{
+	size_t i = 0;
+
+	for (; i + COMPARE_BLOCK <= size; i += COMPARE_BLOCK) {
+		uint8x16_t acc = vdupq_n_u8(0);
+		for (size_t j = 0; j < COMPARE_BLOCK; j += 16)
+			acc = vorrq_u8(acc, veorq_u8(vld1q_u8(a + i + j), vld1q_u8(b + i + j)));
+
+		uint64x2_t acc64 = vreinterpretq_u64_u8(acc);
+		if ((vgetq_lane_u64(acc64, 0) | vgetq_lane_u64(acc64, 1)) != 0)
+			return false;
+	}
+
+	return scalar_bytes_equal(a + i, b + i, size - i);
+}
+
+static void neon_audio_levels(const float *samples, size_t count, float *sum_sq, float *peak, bool *all_zero)
+{
+	float32x4_t vsum = vdupq_n_f32(0.0f);
+	float32x4_t vmax = vdupq_n_f32(0.0f);
+	size_t i = 0;
+	float sum = 0.0f;
+	float max = 0.0f;
+
+	for (; i + 4 <= count; i += 4) {
+		float32x4_t v = vld1q_f32(samples + i);
+		vsum = vmlaq_f32(vsum, v, v);
+		vmax = vmaxq_f32(vmax, vabsq_f32(v));
+	}
+
+	float lanes_sum[4], lanes_max[4];
+	vst1q_f32(lanes_sum, vsum);
+	vst1q_f32(lanes_max, vmax);
+	for (size_t j = 0; j < 4; j++) {
+		sum += lanes_sum[j];
+		max = lanes_max[j] > max ? lanes_max[j] : max;
+	}
+
+	for (; i < count; i++) {
+		float a = fabsf(samples[i]);
+		sum += samples[i] * samples[i];
+		max = a > max ? a : max;
+	}
+
+	*sum_sq = sum;
+	*peak = max;
+	// Only a packet of exact +0.0/-0.0 samples has a zero peak
+	*all_zero = max == 0.0f;
+}
+
+static inline void accumulate_luma(uint8x16_t v, uint64x2_t *sum, uint64x2_t *sum_sq)
+{
+	uint32x4_t sq = vpaddlq_u16(vmull_u8(vget_low_u8(v), vget_low_u8(v)));
+	sq = vpadalq_u16(sq, vmull_u8(vget_high_u8(v), vget_high_u8(v)));
+
+	*sum = vpadalq_u32(*sum, vpaddlq_u16(vpaddlq_u8(v)));
+	*sum_sq = vpadalq_u32(*sum_sq, sq);
+}
+
+static void neon_luma_sums_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint64_t *sum,
+			      uint64_t *sum_sq)
+{
+	uint64x2_t vsum = vdupq_n_u64(0);
+	uint64x2_t vsum_sq = vdupq_n_u64(0);
+	size_t i = 0;
+
+	if (step == 1) {
+		for (; i + 16 <= count; i += 16)
+			accumulate_luma(vld1q_u8(pixels + i), &vsum, &vsum_sq);
+	} else if (step == 2) {
+		for (; i + 16 <= count; i += 16) {
+			uint8x16x2_t v = vld2q_u8(pixels + i * 2);
+			accumulate_luma(offset ? v.val[1] : v.val[0], &vsum, &vsum_sq);
+		}
+	} else if (step == 4) {
+		for (; i + 16 <= count; i += 16) {
+			uint8x16x4_t v = vld4q_u8(pixels + i * 4);
+			accumulate_luma(v.val[offset & 3], &vsum, &vsum_sq);
+		}
+	}
+
+	*sum += vgetq_lane_u64(vsum, 0) + vgetq_lane_u64(vsum, 1);
+	*sum_sq += vgetq_lane_u64(vsum_sq, 0) + vgetq_lane_u64(vsum_sq, 1);
+
+	scalar_luma_sums_u8(pixels + i * step, count - i, step, offset, sum, sum_sq);
+}
+
+static void neon_extract_luma_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint8_t *luma)
+{
+	size_t i = 0;
+
+	if (step == 2) {
+		for (; i + 16 <= count; i += 16) {
+			uint8x16x2_t v = vld2q_u8(pixels + i * 2);
+			vst1q_u8(luma + i, offset ? v.val[1] : v.val[0]);
+		}
+	} else if (step == 4) {
+		for (; i + 16 <= count; i += 16) {
+			uint8x16x4_t v = vld4q_u8(pixels + i * 4);
+			vst1q_u8(luma + i, v.val[offset & 3]);
+		}
+	}
+
+	scalar_extract_luma_u8(pixels + i * step, count - i, step, offset, luma + i);
+}
+
+static void neon_extract_luma_u16(const uint16_t *samples, size_t count, unsigned shift, uint8_t *luma)
+{
+	const int16x8_t vshift = vdupq_n_s16(-(int16_t)shift);
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16) {
+		uint8x8_t lo = vmovn_u16(vshlq_u16(vld1q_u16(samples + i), vshift));
+		uint8x8_t hi = vmovn_u16(vshlq_u16(vld1q_u16(samples + i + 8), vshift));
+		vst1q_u8(luma + i, vcombine_u8(lo, hi));
+	}
+
+	scalar_extract_luma_u16(samples + i, count - i, shift, luma + i);
+}
+
+static void neon_extract_luma_rgb32(const uint8_t *pixels, size_t count, bool bgr, uint8_t *luma)
+{
+	const uint8x8_t w0 = vdup_n_u8(bgr ? LUMA_WEIGHT_B : LUMA_WEIGHT_R);
+	const uint8x8_t w1 = vdup_n_u8(LUMA_WEIGHT_G);
+	const uint8x8_t w2 = vdup_n_u8(bgr ? LUMA_WEIGHT_R : LUMA_WEIGHT_B);
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16) {
+		uint8x16x4_t v = vld4q_u8(pixels + i * 4);
+
+		uint16x8_t lo = vmull_u8(vget_low_u8(v.val[0]), w0);
+		lo = vmlal_u8(lo, vget_low_u8(v.val[1]), w1);
+		lo = vmlal_u8(lo, vget_low_u8(v.val[2]), w2);
+		uint16x8_t hi = vmull_u8(vget_high_u8(v.val[0]), w0);
+		hi = vmlal_u8(hi, vget_high_u8(v.val[1]), w1);
+		hi = vmlal_u8(hi, vget_high_u8(v.val[2]), w2);
+
+		vst1q_u8(luma + i, vcombine_u8(vrshrn_n_u16(lo, 8), vrshrn_n_u16(hi, 8)));
+	}
+
+	scalar_extract_luma_rgb32(pixels + i * 4, count - i, bgr, luma + i);
+}
+
+static void neon_box8_accumulate(const uint8_t *row, size_t groups, uint16_t *sums)
+{
+	size_t g = 0;
+
+	for (; g + 8 <= groups; g += 8) {
+		uint16x4_t quads[4];
+
+		for (size_t j = 0; j < 4; j++) {
+			uint16x8_t pairs = vpaddlq_u8(vld1q_u8(row + g * 8 + j * 16));
+			quads[j] = vpadd_u16(vget_low_u16(pairs), vget_high_u16(pairs));
+		}
+
+		uint16x8_t packed = vcombine_u16(vpadd_u16(quads[0], quads[1]), vpadd_u16(quads[2], quads[3]));
+		vst1q_u16(sums + g, vaddq_u16(vld1q_u16(sums + g), packed));
+	}
+
+	scalar_box8_accumulate(row + g * 8, groups - g, sums + g);
+}
+
+static uint8_t neon_max_abs_diff(const uint8_t *a, const uint8_t *b, size_t count)
+{
+	uint8x16_t vmax = vdupq_n_u8(0);
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16)
+		vmax = vmaxq_u8(vmax, vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+
+	uint8_t max = scalar_max_abs_diff(a + i, b + i, count - i);
+	uint8_t lanes[16];
+	vst1q_u8(lanes, vmax);
+	for (size_t j = 0; j < 16; j++)
+		max = lanes[j] > max ? lanes[j] : max;
+
+	return max;
+}
+
+const struct simd_kernel_table simd_neon_kernels = {
+	neon_bytes_equal,
+	neon_audio_levels,
+	neon_luma_sums_u8,
+	neon_extract_luma_u8,
+	neon_extract_luma_u16,
+	neon_extract_luma_rgb32,
+	neon_box8_accumulate,
+	neon_max_abs_diff,
+};
+
+#endif
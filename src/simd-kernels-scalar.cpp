@@ -0,0 +1,111 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "simd-kernel-table.h"
+
+#include <math.h>
+#include <string.h>
+
+// Portable fallback for CPUs without a vector tier, and the tails of the vector kernels
+
+bool scalar_bytes_equal(const uint8_t *a, const uint8_t *b, size_t size)
+{
+	return memcmp(a, b, size) == 0;
+}
+
+static void scalar_audio_levels(const float *samples, size_t count, float *sum_sq, float *peak, bool *all_zero)
+{
+	float sum = 0.0f;
+	float max = 0.0f;
+
+	for (size_t i = 0; i < count; i++) {
+		float a = fabsf(samples[i]);
+		sum += samples[i] * samples[i];
+		max = a > max ? a : max;
+	}
+
+	*sum_sq = sum;
+	*peak = max;
+	*all_zero = max == 0.0f;
+}
+
+void scalar_luma_sums_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint64_t *sum,
+			 uint64_t *sum_sq)
+{
+	for (size_t i = 0; i < count; i++) {
+		uint32_t v = pixels[i * step + offset];
+		*sum += v;
+		*sum_sq += v * v;
+	}
+}
+
+void scalar_extract_luma_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint8_t *luma)
+{
+	for (size_t i = 0; i < count; i++)
+		luma[i] = pixels[i * step + offset];
+}
+
+void scalar_extract_luma_u16(const uint16_t *samples, size_t count, unsigned shift, uint8_t *luma)
+{
+	for (size_t i = 0; i < count; i++)
+		luma[i] = (uint8_t)(samples[i] >> shift);
+}
+
+void scalar_extract_luma_rgb32(const uint8_t *pixels, size_t count, bool bgr, uint8_t *luma)
+{
+	const uint32_t w0 = bgr ? LUMA_WEIGHT_B : LUMA_WEIGHT_R;
+	const uint32_t w2 = bgr ? LUMA_WEIGHT_R : LUMA_WEIGHT_B;
+
+	for (size_t i = 0; i < count; i++) {
+		const uint8_t *p = pixels + i * 4;
+		luma[i] = (uint8_t)((p[0] * w0 + p[1] * LUMA_WEIGHT_G + p[2] * w2 + 128) >> 8);
+	}
+}
+
+void scalar_box8_accumulate(const uint8_t *row, size_t groups, uint16_t *sums)
+{
+	for (size_t g = 0; g < groups; g++) {
+		uint32_t sum = 0;
+		for (size_t j = 0; j < 8; j++)
+			sum += row[g * 8 + j];
+		sums[g] = (uint16_t)(sums[g] + sum);
+	}
+}
+
+uint8_t scalar_max_abs_diff(const uint8_t *a, const uint8_t *b, size_t count)
+{
+	uint8_t max = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		uint8_t d = a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+		max = d > max ? d : max;
+	}
+
+	return max;
+}
+
+const struct simd_kernel_table simd_scalar_kernels = {
+	scalar_bytes_equal,
+	scalar_audio_levels,
+	scalar_luma_sums_u8,
+	scalar_extract_luma_u8,
+	scalar_extract_luma_u16,
+	scalar_extract_luma_rgb32,
+	scalar_box8_accumulate,
+	scalar_max_abs_diff,
+};
@@ -0,0 +1,268 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "simd-kernel-table.h"
+
+#if defined(SIMD_KERNELS_X86)
+
+#include <emmintrin.h>
+#include <math.h>
+
+// SSE2 is part of x86-64, so this tier is available on every x86 CPU we run on
+
+// Differences are accumulated over this many bytes before branching
+#define COMPARE_BLOCK 128
+
+static bool sse2_bytes_equal(const uint8_t *a, const uint8_t *b, size_t size)
+{
+	size_t i = 0;
+
+	for (; i + COMPARE_BLOCK <= size; i += COMPARE_BLOCK) {
+		__m128i acc = _mm_setzero_si128();
+		for (size_t j = 0; j < COMPARE_BLOCK; j += 16) {
+			__m128i va = _mm_loadu_si128((const __m128i *)(a + i + j));
+			__m128i vb = _mm_loadu_si128((const __m128i *)(b + i + j));
+			acc = _mm_or_si128(acc, _mm_xor_si128(va, vb));
+		}
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(acc, _mm_setzero_si128())) != 0xFFFF)
+			return false;
+	}
+
+	return scalar_bytes_equal(a + i, b + i, size - i);
+}
+
+static void sse2_audio_levels(const float *samples, size_t count, float *sum_sq, float *peak, bool *all_zero)
+{
+	const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	__m128 vsum = _mm_setzero_ps();
+	__m128 vmax = _mm_setzero_ps();
+	size_t i = 0;
+	float sum = 0.0f;
+	float max = 0.0f;
+
+	for (; i + 4 <= count; i += 4) {
+		__m128 v = _mm_loadu_ps(samples + i);
+		vsum = _mm_add_ps(vsum, _mm_mul_ps(v, v));
+		vmax = _mm_max_ps(vmax, _mm_and_ps(v, abs_mask));
+	}
+
+	float lanes_sum[4], lanes_max[4];
+	_mm_storeu_ps(lanes_sum, vsum);
+	_mm_storeu_ps(lanes_max, vmax);
+	for (size_t j = 0; j < 4; j++) {
+		sum += lanes_sum[j];
+		max = lanes_max[j] > max ? lanes_max[j] : max;
+	}
+
+	for (; i < count; i++) {
+		float a = fabsf(samples[i]);
+		sum += samples[i] * samples[i];
+		max = a > max ? a : max;
+	}
+
+	*sum_sq = sum;
+	*peak = max;
+	// Only a packet of exact +0.0/-0.0 samples has a zero peak
+	*all_zero = max == 0.0f;
+}
+
+// v holds values up to 255 in 16-bit (or wider) lanes
+static inline void accumulate_luma(__m128i v, __m128i *sum, __m128i *sum_sq)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i sq = _mm_madd_epi16(v, v);
+
+	*sum = _mm_add_epi64(*sum, _mm_sad_epu8(v, zero));
+	*sum_sq = _mm_add_epi64(*sum_sq, _mm_unpacklo_epi32(sq, zero));
+	*sum_sq = _mm_add_epi64(*sum_sq, _mm_unpackhi_epi32(sq, zero));
+}
+
+void sse2_luma_sums_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint64_t *sum,
+		       uint64_t *sum_sq)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i vsum = zero;
+	__m128i vsum_sq = zero;
+	size_t i = 0;
+
+	if (step == 1) {
+		for (; i + 16 <= count; i += 16) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(pixels + i));
+			accumulate_luma(_mm_unpacklo_epi8(v, zero), &vsum, &vsum_sq);
+			accumulate_luma(_mm_unpackhi_epi8(v, zero), &vsum, &vsum_sq);
+		}
+	} else if (step == 2) {
+		const __m128i shift = _mm_cvtsi32_si128((int)offset * 8);
+		const __m128i mask = _mm_set1_epi16(0xFF);
+
+		for (; i + 8 <= count; i += 8) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(pixels + i * 2));
+			accumulate_luma(_mm_and_si128(_mm_srl_epi16(v, shift), mask), &vsum, &vsum_sq);
+		}
+	} else if (step == 4) {
+		const __m128i shift = _mm_cvtsi32_si128((int)offset * 8);
+		const __m128i mask = _mm_set1_epi32(0xFF);
+
+		for (; i + 4 <= count; i += 4) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(pixels + i * 4));
+			accumulate_luma(_mm_and_si128(_mm_srl_epi32(v, shift), mask), &vsum, &vsum_sq);
+		}
+	}
+
+	uint64_t lanes[2];
+	_mm_storeu_si128((__m128i *)lanes, vsum);
+	*sum += lanes[0] + lanes[1];
+	_mm_storeu_si128((__m128i *)lanes, vsum_sq);
+	*sum_sq += lanes[0] + lanes[1];
+
+	scalar_luma_sums_u8(pixels + i * step, count - i, step, offset, sum, sum_sq);
+}
+
+void sse2_extract_luma_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint8_t *luma)
+{
+	const __m128i shift = _mm_cvtsi32_si128((int)offset * 8);
+	size_t i = 0;
+
+	if (step == 2) {
+		const __m128i mask = _mm_set1_epi16(0xFF);
+
+		for (; i + 16 <= count; i += 16) {
+			__m128i a = _mm_loadu_si128((const __m128i *)(pixels + i * 2));
+			__m128i b = _mm_loadu_si128((const __m128i *)(pixels + i * 2 + 16));
+			a = _mm_and_si128(_mm_srl_epi16(a, shift), mask);
+			b = _mm_and_si128(_mm_srl_epi16(b, shift), mask);
+			_mm_storeu_si128((__m128i *)(luma + i), _mm_packus_epi16(a, b));
+		}
+	} else if (step == 4) {
+		const __m128i mask = _mm_set1_epi32(0xFF);
+
+		for (; i + 16 <= count; i += 16) {
+			__m128i v[4];
+			for (size_t j = 0; j < 4; j++) {
+				v[j] = _mm_loadu_si128((const __m128i *)(pixels + (i + j * 4) * 4));
+				v[j] = _mm_and_si128(_mm_srl_epi32(v[j], shift), mask);
+			}
+			__m128i lo = _mm_packs_epi32(v[0], v[1]);
+			__m128i hi = _mm_packs_epi32(v[2], v[3]);
+			_mm_storeu_si128((__m128i *)(luma + i), _mm_packus_epi16(lo, hi));
+		}
+	}
+
+	scalar_extract_luma_u8(pixels + i * step, count - i, step, offset, luma + i);
+}
+
+void sse2_extract_luma_u16(const uint16_t *samples, size_t count, unsigned shift, uint8_t *luma)
+{
+	const __m128i vshift = _mm_cvtsi32_si128((int)shift);
+	const __m128i mask = _mm_set1_epi16(0xFF);
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(samples + i));
+		__m128i b = _mm_loadu_si128((const __m128i *)(samples + i + 8));
+		a = _mm_and_si128(_mm_srl_epi16(a, vshift), mask);
+		b = _mm_and_si128(_mm_srl_epi16(b, vshift), mask);
+		_mm_storeu_si128((__m128i *)(luma + i), _mm_packus_epi16(a, b));
+	}
+
+	scalar_extract_luma_u16(samples + i, count - i, shift, luma + i);
+}
+
+void sse2_extract_luma_rgb32(const uint8_t *pixels, size_t count, bool bgr, uint8_t *luma)
+{
+	const short w0 = bgr ? LUMA_WEIGHT_B : LUMA_WEIGHT_R;
+	const short w2 = bgr ? LUMA_WEIGHT_R : LUMA_WEIGHT_B;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i weights = _mm_set_epi16(0, w2, LUMA_WEIGHT_G, w0, 0, w2, LUMA_WEIGHT_G, w0);
+	const __m128i round = _mm_set1_epi32(128);
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16) {
+		__m128i y[4];
+
+		for (size_t j = 0; j < 4; j++) {
+			__m128i v = _mm_loadu_si128((const __m128i *)(pixels + (i + j * 4) * 4));
+
+			// Two 32-bit partial sums per pixel, added pairwise and gathered into one lane per pixel
+			__m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(v, zero), weights);
+			__m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(v, zero), weights);
+			lo = _mm_shuffle_epi32(_mm_add_epi32(lo, _mm_srli_epi64(lo, 32)), _MM_SHUFFLE(3, 1, 2, 0));
+			hi = _mm_shuffle_epi32(_mm_add_epi32(hi, _mm_srli_epi64(hi, 32)), _MM_SHUFFLE(3, 1, 2, 0));
+			y[j] = _mm_srli_epi32(_mm_add_epi32(_mm_unpacklo_epi64(lo, hi), round), 8);
+		}
+
+		__m128i lo = _mm_packs_epi32(y[0], y[1]);
+		__m128i hi = _mm_packs_epi32(y[2], y[3]);
+		_mm_storeu_si128((__m128i *)(luma + i), _mm_packus_epi16(lo, hi));
+	}
+
+	scalar_extract_luma_rgb32(pixels + i * 4, count - i, bgr, luma + i);
+}
+
+static void sse2_box8_accumulate(const uint8_t *row, size_t groups, uint16_t *sums)
+{
+	const __m128i zero = _mm_setzero_si128();
+	size_t g = 0;
+
+	for (; g + 8 <= groups; g += 8) {
+		// Each psadbw leaves two 8-byte sums in 64-bit lanes, the packs squeeze eight of them into 16-bit lanes
+		__m128i s0 = _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(row + g * 8)), zero);
+		__m128i s1 = _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(row + g * 8 + 16)), zero);
+		__m128i s2 = _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(row + g * 8 + 32)), zero);
+		__m128i s3 = _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(row + g * 8 + 48)), zero);
+		__m128i packed = _mm_packs_epi32(_mm_packs_epi32(s0, s1), _mm_packs_epi32(s2, s3));
+
+		__m128i acc = _mm_loadu_si128((const __m128i *)(sums + g));
+		_mm_storeu_si128((__m128i *)(sums + g), _mm_add_epi16(acc, packed));
+	}
+
+	scalar_box8_accumulate(row + g * 8, groups - g, sums + g);
+}
+
+static uint8_t sse2_max_abs_diff(const uint8_t *a, const uint8_t *b, size_t count)
+{
+	__m128i vmax = _mm_setzero_si128();
+	size_t i = 0;
+
+	for (; i + 16 <= count; i += 16) {
+		__m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+		vmax = _mm_max_epu8(vmax, _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va)));
+	}
+
+	uint8_t max = scalar_max_abs_diff(a + i, b + i, count - i);
+	uint8_t lanes[16];
+	_mm_storeu_si128((__m128i *)lanes, vmax);
+	for (size_t j = 0; j < 16; j++)
+		max = lanes[j] > max ? lanes[j] : max;
+
+	return max;
+}
+
+const struct simd_kernel_table simd_sse2_kernels = {
+	sse2_bytes_equal,
+	sse2_audio_levels,
+	sse2_luma_sums_u8,
+	sse2_extract_luma_u8,
+	sse2_extract_luma_u16,
+	sse2_extract_luma_rgb32,
+	sse2_box8_accumulate,
+	sse2_max_abs_diff,
+};
+
+#endif
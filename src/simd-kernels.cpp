@@ -0,0 +1,214 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "simd-kernels.h"
+#include "simd-kernel-table.h"
+
+#include <obs-module.h>
+#include <plugin-support.h>
+
+#include <atomic>
+
+#if defined(SIMD_KERNELS_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(SIMD_KERNELS_X86)
+#include <cpuid.h>
+#elif defined(SIMD_KERNELS_ARM64) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+#if defined(SIMD_KERNELS_X86)
+#define BASELINE_KERNELS simd_sse2_kernels
+#elif defined(SIMD_KERNELS_ARM64)
+#define BASELINE_KERNELS simd_neon_kernels
+#else
+#define BASELINE_KERNELS simd_scalar_kernels
+#endif
+
+// Until simd_kernels_select runs, the kernels every CPU of the build target has
+static std::atomic<const struct simd_kernel_table *> active_kernels{&BASELINE_KERNELS};
+static std::atomic<int> active_tier{SIMD_TIER_AUTO};
+
+#if defined(SIMD_KERNELS_X86)
+static bool detect_avx2(void)
+{
+	// Leaf 1 ECX: OSXSAVE (27) and AVX (28). Leaf 7 EBX: AVX2 (5). XCR0 bits 1 and 2: the OS saves the
+	// XMM and YMM registers on context switches.
+#if defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+	__cpuid(info, 1);
+	if ((info[2] & (3 << 27)) != (3 << 27) || (_xgetbv(0) & 6) != 6)
+		return false;
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	unsigned int eax, ebx, ecx, edx;
+	unsigned int xcr0_lo, xcr0_hi;
+
+	if (__get_cpuid_max(0, nullptr) < 7)
+		return false;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return false;
+	if ((ecx & (3u << 27)) != (3u << 27))
+		return false;
+	__asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+	if ((xcr0_lo & 6) != 6)
+		return false;
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+	return (ebx & (1u << 5)) != 0;
+#endif
+}
+#elif defined(SIMD_KERNELS_ARM64)
+static bool detect_neon(void)
+{
+	// Advanced SIMD is mandatory on AArch64; Linux still reports it, which catches an odd emulator
+#if defined(__linux__)
+	return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#else
+	return true;
+#endif
+}
+#endif
+
+static const struct simd_kernel_table *tier_kernels(enum simd_tier tier)
+{
+	switch (tier) {
+	case SIMD_TIER_SCALAR:
+		return &simd_scalar_kernels;
+#if defined(SIMD_KERNELS_X86)
+	case SIMD_TIER_SSE2:
+		return &simd_sse2_kernels;
+	case SIMD_TIER_AVX2: {
+		static const bool has_avx2 = detect_avx2();
+		return has_avx2 ? &simd_avx2_kernels : nullptr;
+	}
+#elif defined(SIMD_KERNELS_ARM64)
+	case SIMD_TIER_NEON: {
+		static const bool has_neon = detect_neon();
+		return has_neon ? &simd_neon_kernels : nullptr;
+	}
+#endif
+	default:
+		return nullptr;
+	}
+}
+
+bool simd_tier_supported(enum simd_tier tier)
+{
+	return tier_kernels(tier) != nullptr;
+}
+
+static enum simd_tier best_tier(void)
+{
+	for (int tier = SIMD_TIER_COUNT - 1; tier > SIMD_TIER_SCALAR; tier--) {
+		if (simd_tier_supported((enum simd_tier)tier))
+			return (enum simd_tier)tier;
+	}
+	return SIMD_TIER_SCALAR;
+}
+
+enum simd_tier simd_kernels_select(enum simd_tier tier)
+{
+	enum simd_tier best = best_tier();
+
+	if (!simd_tier_supported(tier))
+		tier = best;
+
+	active_kernels.store(tier_kernels(tier), std::memory_order_relaxed);
+	int previous = active_tier.exchange(tier, std::memory_order_relaxed);
+
+	// Filters reselect whenever their settings change, only log the switches
+	if (previous != tier) {
+		if (tier == best)
+			obs_log(LOG_INFO, "using %s analysis kernels", simd_tier_name(tier));
+		else
+			obs_log(LOG_INFO, "using %s analysis kernels (forced by setting, %s available)", simd_tier_name(tier),
+				simd_tier_name(best));
+	}
+
+	return tier;
+}
+
+enum simd_tier simd_kernels_tier(void)
+{
+	return (enum simd_tier)active_tier.load(std::memory_order_relaxed);
+}
+
+const char *simd_tier_name(enum simd_tier tier)
+{
+	switch (tier) {
+	case SIMD_TIER_AUTO:
+		return "auto";
+	case SIMD_TIER_SCALAR:
+		return "scalar";
+	case SIMD_TIER_SSE2:
+		return "SSE2";
+	case SIMD_TIER_AVX2:
+		return "AVX2";
+	case SIMD_TIER_NEON:
+		return "NEON";
+	default:
+		return "unknown";
+	}
+}
+
+bool simd_bytes_equal(const uint8_t *a, const uint8_t *b, size_t size)
+{
+	return active_kernels.load(std::memory_order_relaxed)->bytes_equal(a, b, size);
+}
+
+void simd_audio_levels(const float *samples, size_t count, float *sum_sq, float *peak, bool *all_zero)
+{
+	active_kernels.load(std::memory_order_relaxed)->audio_levels(samples, count, sum_sq, peak, all_zero);
+}
+
+void simd_luma_sums_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint64_t *sum,
+		       uint64_t *sum_sq)
+{
+	active_kernels.load(std::memory_order_relaxed)->luma_sums_u8(pixels, count, step, offset, sum, sum_sq);
+}
+
+void simd_extract_luma_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint8_t *luma)
+{
+	active_kernels.load(std::memory_order_relaxed)->extract_luma_u8(pixels, count, step, offset, luma);
+}
+
+void simd_extract_luma_u16(const uint16_t *samples, size_t count, unsigned shift, uint8_t *luma)
+{
+	active_kernels.load(std::memory_order_relaxed)->extract_luma_u16(samples, count, shift, luma);
+}
+
+void simd_extract_luma_rgb32(const uint8_t *pixels, size_t count, bool bgr, uint8_t *luma)
+{
+	active_kernels.load(std::memory_order_relaxed)->extract_luma_rgb32(pixels, count, bgr, luma);
+}
+
+void simd_box8_accumulate(const uint8_t *row, size_t groups, uint16_t *sums)
+{
+	active_kernels.load(std::memory_order_relaxed)->box8_accumulate(row, groups, sums);
+}
+
+uint8_t simd_max_abs_diff(const uint8_t *a, const uint8_t *b, size_t count)
+{
+	return active_kernels.load(std::memory_order_relaxed)->max_abs_diff(a, b, count);
+}
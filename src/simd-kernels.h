@@ -0,0 +1,74 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Instruction set tiers the kernels are built for. Values are stored in settings, so only append.
+enum simd_tier {
+	SIMD_TIER_AUTO,
+	SIMD_TIER_SCALAR,
+	SIMD_TIER_SSE2,
+	SIMD_TIER_AVX2,
+	SIMD_TIER_NEON,
+	SIMD_TIER_COUNT,
+};
+
+// Switches every simd_* function to the kernels of tier. SIMD_TIER_AUTO, or a tier this CPU or build lacks,
+// selects the best supported one. Safe to call while kernels run on other threads. Returns the tier in use.
+enum simd_tier simd_kernels_select(enum simd_tier tier);
+
+// The tier in use, SIMD_TIER_AUTO before the first simd_kernels_select.
+enum simd_tier simd_kernels_tier(void);
+bool simd_tier_supported(enum simd_tier tier);
+const char *simd_tier_name(enum simd_tier tier);
+
+// Returns true if the two byte ranges are identical. Exits early on the first differing block.
+bool simd_bytes_equal(const uint8_t *a, const uint8_t *b, size_t size);
+
+// Sum of squares and absolute peak of the samples. all_zero is set if every sample is exactly 0.
+void simd_audio_levels(const float *samples, size_t count, float *sum_sq, float *peak, bool *all_zero);
+
+// BT.709 luma weights scaled to 256
+#define LUMA_WEIGHT_R 54
+#define LUMA_WEIGHT_G 183
+#define LUMA_WEIGHT_B 19
+
+// Adds the sum and sum of squares of count 8-bit luma values to *sum and *sum_sq. Each value is the byte at
+// offset in a pixel of step bytes. Steps of 1, 2 and 4 are vectorized.
+void simd_luma_sums_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint64_t *sum,
+		       uint64_t *sum_sq);
+
+// The extract kernels write count 8-bit luma values to luma.
+
+// The byte at offset in pixels of step bytes. Steps of 2 and 4 are vectorized; step 1 needs no extraction.
+void simd_extract_luma_u8(const uint8_t *pixels, size_t count, size_t step, size_t offset, uint8_t *luma);
+
+// 16-bit samples, shifted right by shift to bring them down to 8 bits.
+void simd_extract_luma_u16(const uint16_t *samples, size_t count, unsigned shift, uint8_t *luma);
+
+// BT.709 luma of 4-byte RGB pixels, in RGBA byte order or in BGRA order if bgr is set.
+void simd_extract_luma_rgb32(const uint8_t *pixels, size_t count, bool bgr, uint8_t *luma);
+
+// Adds the sum of each group of 8 bytes in row to the matching entry of sums.
+void simd_box8_accumulate(const uint8_t *row, size_t groups, uint16_t *sums);
+
+// Largest absolute difference between the bytes of a and b.
+uint8_t simd_max_abs_diff(const uint8_t *a, const uint8_t *b, size_t count);
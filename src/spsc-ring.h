@@ -0,0 +1,78 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#define SPSC_CACHE_LINE 64
+
+// Fixed size single-producer/single-consumer queue. Push never waits: if the consumer falls behind
+// the record is dropped and counted instead. Safe to zero-initialize (bzalloc).
+template<typename T, size_t N> struct spsc_ring {
+	static_assert((N & (N - 1)) == 0, "spsc_ring size must be a power of two");
+
+	std::atomic<size_t> head; // written by the producer
+	char pad0[SPSC_CACHE_LINE - sizeof(std::atomic<size_t>)];
+	std::atomic<size_t> tail; // written by the consumer
+	char pad1[SPSC_CACHE_LINE - sizeof(std::atomic<size_t>)];
+	std::atomic<uint64_t> dropped;
+
+	T items[N];
+};
+
+template<typename T, size_t N> static inline bool spsc_push(spsc_ring<T, N> *ring, const T &item)
+{
+	size_t head = ring->head.load(std::memory_order_relaxed);
+
+	if (head - ring->tail.load(std::memory_order_acquire) == N) {
+		ring->dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	ring->items[head & (N - 1)] = item;
+	ring->head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+template<typename T, size_t N> static inline bool spsc_pop(spsc_ring<T, N> *ring, T *item)
+{
+	size_t tail = ring->tail.load(std::memory_order_relaxed);
+
+	if (tail == ring->head.load(std::memory_order_acquire))
+		return false;
+
+	*item = ring->items[tail & (N - 1)];
+	ring->tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+// Either side: number of queued records, may be stale by the time it returns.
+template<typename T, size_t N> static inline size_t spsc_size(spsc_ring<T, N> *ring)
+{
+	return ring->head.load(std::memory_order_acquire) - ring->tail.load(std::memory_order_acquire);
+}
+
+// Consumer side: throw away everything queued so far.
+template<typename T, size_t N> static inline void spsc_clear(spsc_ring<T, N> *ring)
+{
+	ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_release);
+}
@@ -0,0 +1,457 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "video-analysis.h"
+#include "hash.h"
+#include "simd-kernels.h"
+
+#include <math.h>
+#include <string.h>
+
+static void set_planes(frame_layout *layout, size_t planes)
+{
+	layout->planes = planes;
+	for (size_t i = planes; i < MAX_AV_PLANES; i++)
+		layout->plane[i] = {0, 0};
+}
+
+bool get_frame_layout(enum video_format format, uint32_t width, uint32_t height, frame_layout *layout)
+{
+	const uint32_t half_w = (width + 1) / 2;
+	const uint32_t half_h = (height + 1) / 2;
+
+	switch (format) {
+	case VIDEO_FORMAT_Y800:
+		set_planes(layout, 1);
+		layout->plane[0] = {width, height};
+		return true;
+	case VIDEO_FORMAT_YVYU:
+	case VIDEO_FORMAT_YUY2:
+	case VIDEO_FORMAT_UYVY:
+		set_planes(layout, 1);
+		layout->plane[0] = {half_w * 4, height};
+		return true;
+	case VIDEO_FORMAT_RGBA:
+	case VIDEO_FORMAT_BGRA:
+	case VIDEO_FORMAT_BGRX:
+	case VIDEO_FORMAT_AYUV:
+	case VIDEO_FORMAT_R10L:
+		set_planes(layout, 1);
+		layout->plane[0] = {width * 4, height};
+		return true;
+	case VIDEO_FORMAT_BGR3:
+		set_planes(layout, 1);
+		layout->plane[0] = {width * 3, height};
+		return true;
+	case VIDEO_FORMAT_V210:
+		set_planes(layout, 1);
+		layout->plane[0] = {(width + 47) / 48 * 128, height};
+		return true;
+	case VIDEO_FORMAT_NV12:
+		set_planes(layout, 2);
+		layout->plane[0] = {width, height};
+		layout->plane[1] = {half_w * 2, half_h};
+		return true;
+	case VIDEO_FORMAT_P010:
+		set_planes(layout, 2);
+		layout->plane[0] = {width * 2, height};
+		layout->plane[1] = {half_w * 4, half_h};
+		return true;
+	case VIDEO_FORMAT_P216:
+		set_planes(layout, 2);
+		layout->plane[0] = {width * 2, height};
+		layout->plane[1] = {half_w * 4, height};
+		return true;
+	case VIDEO_FORMAT_P416:
+		set_planes(layout, 2);
+		layout->plane[0] = {width * 2, height};
+		layout->plane[1] = {width * 4, height};
+		return true;
+	case VIDEO_FORMAT_I420:
+	case VIDEO_FORMAT_I40A:
+		set_planes(layout, format == VIDEO_FORMAT_I40A ? 4 : 3);
+		layout->plane[0] = {width, height};
+		layout->plane[1] = {half_w, half_h};
+		layout->plane[2] = {half_w, half_h};
+		layout->plane[3] = {width, height};
+		return true;
+	case VIDEO_FORMAT_I422:
+	case VIDEO_FORMAT_I42A:
+		set_planes(layout, format == VIDEO_FORMAT_I42A ? 4 : 3);
+		layout->plane[0] = {width, height};
+		layout->plane[1] = {half_w, height};
+		layout->plane[2] = {half_w, height};
+		layout->plane[3] = {width, height};
+		return true;
+	case VIDEO_FORMAT_I444:
+	case VIDEO_FORMAT_YUVA:
+		set_planes(layout, format == VIDEO_FORMAT_YUVA ? 4 : 3);
+		for (size_t i = 0; i < 4; i++)
+			layout->plane[i] = {width, height};
+		return true;
+	case VIDEO_FORMAT_I010:
+		set_planes(layout, 3);
+		layout->plane[0] = {width * 2, height};
+		layout->plane[1] = {half_w * 2, half_h};
+		layout->plane[2] = {half_w * 2, half_h};
+		return true;
+	case VIDEO_FORMAT_I210:
+		set_planes(layout, 3);
+		layout->plane[0] = {width * 2, height};
+		layout->plane[1] = {half_w * 2, height};
+		layout->plane[2] = {half_w * 2, height};
+		return true;
+	case VIDEO_FORMAT_I412:
+	case VIDEO_FORMAT_YA2L:
+		set_planes(layout, format == VIDEO_FORMAT_YA2L ? 4 : 3);
+		for (size_t i = 0; i < 4; i++)
+			layout->plane[i] = {width * 2, height};
+		return true;
+	default:
+		set_planes(layout, 0);
+		return false;
+	}
+}
+
+void frame_compare_free(frame_compare *cmp)
+{
+	for (size_t i = 0; i < MAX_AV_PLANES; i++) {
+		bfree(cmp->planes[i]);
+		cmp->planes[i] = nullptr;
+	}
+	cmp->valid = false;
+}
+
+static bool frame_compare_reset(frame_compare *cmp, const struct obs_source_frame *frame)
+{
+	frame_compare_free(cmp);
+
+	cmp->format = frame->format;
+	cmp->width = frame->width;
+	cmp->height = frame->height;
+
+	if (!get_frame_layout(frame->format, frame->width, frame->height, &cmp->layout))
+		return false;
+
+	for (size_t i = 0; i < cmp->layout.planes; i++) {
+		const plane_layout &plane = cmp->layout.plane[i];
+		cmp->planes[i] = (uint8_t *)bmalloc((size_t)plane.row_bytes * plane.rows);
+	}
+
+	return true;
+}
+
+bool frame_compare_update(frame_compare *cmp, const struct obs_source_frame *frame)
+{
+	if (!cmp->valid || cmp->format != frame->format || cmp->width != frame->width ||
+	    cmp->height != frame->height) {
+		if (!frame_compare_reset(cmp, frame))
+			return true;
+	}
+
+	bool changed = !cmp->valid;
+
+	for (size_t i = 0; i < cmp->layout.planes; i++) {
+		const plane_layout &plane = cmp->layout.plane[i];
+		const uint8_t *src = frame->data[i];
+		uint8_t *ref = cmp->planes[i];
+		size_t row_bytes = plane.row_bytes;
+
+		if (!src)
+			continue;
+		if (frame->linesize[i] < row_bytes)
+			row_bytes = frame->linesize[i];
+
+		for (uint32_t y = 0; y < plane.rows; y++) {
+			// Rows before the first difference already match the reference, everything after it is copied
+			if (changed || !simd_bytes_equal(src, ref, row_bytes)) {
+				changed = true;
+				memcpy(ref, src, row_bytes);
+			}
+
+			src += frame->linesize[i];
+			ref += plane.row_bytes;
+		}
+	}
+
+	cmp->valid = true;
+	return changed;
+}
+
+#define SAMPLE_BYTES 16
+
+uint64_t hash_frame_samples(const struct obs_source_frame *frame, const frame_layout *layout, uint32_t samples,
+			    uint64_t seed)
+{
+	uint64_t hash = seed ^ 0xcbf29ce484222325ULL;
+	uint32_t grid = (uint32_t)ceil(sqrt((double)samples));
+
+	if (grid == 0)
+		grid = 1;
+
+	for (size_t i = 0; i < layout->planes; i++) {
+		const plane_layout &plane = layout->plane[i];
+		const uint8_t *data = frame->data[i];
+		uint32_t row_bytes = plane.row_bytes < frame->linesize[i] ? plane.row_bytes : frame->linesize[i];
+
+		if (!data || row_bytes < SAMPLE_BYTES || plane.rows == 0)
+			continue;
+
+		uint32_t grid_x = grid < row_bytes / SAMPLE_BYTES ? grid : row_bytes / SAMPLE_BYTES;
+		uint32_t grid_y = grid < plane.rows ? grid : plane.rows;
+		uint32_t cell_w = row_bytes / grid_x;
+		uint32_t cell_h = plane.rows / grid_y;
+		uint64_t rng = seed + i;
+
+		// Stratified sampling: one randomly placed block inside every grid cell
+		for (uint32_t cy = 0; cy < grid_y; cy++) {
+			for (uint32_t cx = 0; cx < grid_x; cx++) {
+				uint64_t r = next_random(&rng);
+				uint32_t y = cy * cell_h + (uint32_t)(r % cell_h);
+				uint32_t x = cx * cell_w + (uint32_t)((r >> 32) % cell_w);
+
+				if (x > row_bytes - SAMPLE_BYTES)
+					x = row_bytes - SAMPLE_BYTES;
+
+				const uint8_t *p = data + (size_t)y * frame->linesize[i] + x;
+				hash = mix64(hash ^ load64(p)) + load64(p + 8);
+			}
+		}
+	}
+
+	return mix64(hash);
+}
+
+bool frame_fingerprint_update(frame_fingerprint *fp, const struct obs_source_frame *frame, uint32_t samples)
+{
+	if (!fp->valid || fp->format != frame->format || fp->width != frame->width || fp->height != frame->height ||
+	    fp->samples != samples) {
+		fp->format = frame->format;
+		fp->width = frame->width;
+		fp->height = frame->height;
+		fp->samples = samples;
+		fp->valid = get_frame_layout(frame->format, frame->width, frame->height, &fp->layout);
+
+		if (!fp->valid)
+			return true;
+
+		fp->next_hash = hash_frame_samples(frame, &fp->layout, samples, ++fp->seed);
+		return true;
+	}
+
+	bool changed = hash_frame_samples(frame, &fp->layout, samples, fp->seed) != fp->next_hash;
+
+	fp->next_hash = hash_frame_samples(frame, &fp->layout, samples, ++fp->seed);
+	return changed;
+}
+
+// A tile counts as changed once any fine-level cell moved by more than this, which noise averaged over
+// 8x8 pixels practically never does
+#define TILE_CHANGE_LEVELS 3
+
+static bool tile_map_reset(tile_map *map, const luma_pyramid *pyramid, uint32_t cols, uint32_t rows)
+{
+	const luma_image &fine = pyramid->fine;
+	size_t size = (size_t)fine.width * fine.height;
+
+	map->cols = cols;
+	map->rows = rows;
+	map->width = fine.width;
+	map->height = fine.height;
+	map->grid_cols = cols < fine.width ? cols : fine.width;
+	map->grid_rows = rows < fine.height ? rows : fine.height;
+	map->valid = false;
+
+	if (map->grid_cols == 0 || map->grid_rows == 0)
+		return false;
+
+	if (map->reference_size != size) {
+		bfree(map->reference);
+		map->reference = (uint8_t *)bmalloc(size);
+		map->reference_size = size;
+	}
+
+	for (uint32_t i = 0; i <= map->grid_cols; i++)
+		map->x_edges[i] = fine.width * i / map->grid_cols;
+	for (uint32_t i = 0; i <= map->grid_rows; i++)
+		map->y_edges[i] = fine.height * i / map->grid_rows;
+
+	memcpy(map->reference, fine.data, size);
+	for (size_t i = 0; i < (size_t)map->grid_cols * map->grid_rows; i++)
+		map->changed_ts[i] = pyramid->timestamp;
+
+	map->valid = true;
+	return true;
+}
+
+void tile_map_update(tile_map *map, const luma_pyramid *pyramid, uint32_t cols, uint32_t rows)
+{
+	if (!pyramid->valid) {
+		map->valid = false;
+		return;
+	}
+
+	if (cols > TILE_MAP_MAX)
+		cols = TILE_MAP_MAX;
+	if (rows > TILE_MAP_MAX)
+		rows = TILE_MAP_MAX;
+
+	if (!map->valid || map->cols != cols || map->rows != rows || map->width != pyramid->fine.width ||
+	    map->height != pyramid->fine.height) {
+		tile_map_reset(map, pyramid, cols, rows);
+		return;
+	}
+
+	const luma_image &fine = pyramid->fine;
+
+	for (uint32_t row = 0; row < map->grid_rows; row++) {
+		for (uint32_t col = 0; col < map->grid_cols; col++) {
+			uint32_t x0 = map->x_edges[col];
+			uint32_t width = map->x_edges[col + 1] - x0;
+			uint8_t diff = 0;
+
+			for (uint32_t y = map->y_edges[row]; y < map->y_edges[row + 1] && diff <= TILE_CHANGE_LEVELS; y++) {
+				size_t offset = (size_t)y * fine.width + x0;
+				diff = simd_max_abs_diff(fine.data + offset, map->reference + offset, width);
+			}
+
+			if (diff <= TILE_CHANGE_LEVELS)
+				continue;
+
+			// Compare against the picture of the last change, so slow fades still add up to one
+			for (uint32_t y = map->y_edges[row]; y < map->y_edges[row + 1]; y++) {
+				size_t offset = (size_t)y * fine.width + x0;
+				memcpy(map->reference + offset, fine.data + offset, width);
+			}
+			map->changed_ts[(size_t)row * map->grid_cols + col] = pyramid->timestamp;
+		}
+	}
+}
+
+void tile_map_free(tile_map *map)
+{
+	bfree(map->reference);
+	map->reference = nullptr;
+	map->reference_size = 0;
+	map->valid = false;
+}
+
+float tile_map_static_area(const tile_map *map, uint64_t now, uint64_t static_ns)
+{
+	if (!map->valid)
+		return 0.0f;
+
+	uint64_t total = 0;
+	uint64_t still = 0;
+
+	for (uint32_t row = 0; row < map->grid_rows; row++) {
+		for (uint32_t col = 0; col < map->grid_cols; col++) {
+			size_t tile = (size_t)row * map->grid_cols + col;
+			uint64_t area = (uint64_t)(map->x_edges[col + 1] - map->x_edges[col]) *
+					(map->y_edges[row + 1] - map->y_edges[row]);
+
+			total += area;
+			if (now > map->changed_ts[tile] && now - map->changed_ts[tile] > static_ns)
+				still += area;
+		}
+	}
+
+	return total ? (float)((double)still / total) : 0.0f;
+}
+
+#define PHASH_COLS 9
+#define PHASH_ROWS 8
+
+// Differences under this many luma levels count as equal, so flat areas don't flip bits on noise
+#define PHASH_MARGIN 0.5f
+
+bool compute_perceptual_hash(const luma_pyramid *pyramid, perceptual_hash *hash)
+{
+	if (!pyramid->valid)
+		return false;
+
+	// The coarse level is plenty unless the frame is tiny
+	const luma_image *image = &pyramid->coarse;
+	if (image->width < PHASH_COLS || image->height < PHASH_ROWS)
+		image = &pyramid->fine;
+	if (image->width < PHASH_COLS || image->height < PHASH_ROWS)
+		return false;
+
+	float grid[PHASH_ROWS][PHASH_COLS];
+
+	for (uint32_t by = 0; by < PHASH_ROWS; by++) {
+		uint32_t y0 = image->height * by / PHASH_ROWS;
+		uint32_t y1 = image->height * (by + 1) / PHASH_ROWS;
+
+		for (uint32_t bx = 0; bx < PHASH_COLS; bx++) {
+			uint32_t x0 = image->width * bx / PHASH_COLS;
+			uint32_t x1 = image->width * (bx + 1) / PHASH_COLS;
+			uint32_t sum = 0;
+
+			for (uint32_t y = y0; y < y1; y++)
+				for (uint32_t x = x0; x < x1; x++)
+					sum += image->data[(size_t)y * image->width + x];
+
+			grid[by][bx] = (float)sum / ((y1 - y0) * (x1 - x0));
+		}
+	}
+
+	float cells[PHASH_ROWS][PHASH_COLS - 1];
+	float mean = 0.0f;
+
+	for (uint32_t y = 0; y < PHASH_ROWS; y++) {
+		for (uint32_t x = 0; x < PHASH_COLS - 1; x++) {
+			cells[y][x] = (grid[y][x] + grid[y][x + 1]) * 0.5f;
+			mean += cells[y][x];
+		}
+	}
+	mean /= PHASH_ROWS * (PHASH_COLS - 1);
+
+	hash->dhash = 0;
+	hash->ahash = 0;
+
+	for (uint32_t y = 0; y < PHASH_ROWS; y++) {
+		for (uint32_t x = 0; x < PHASH_COLS - 1; x++) {
+			uint32_t bit = y * (PHASH_COLS - 1) + x;
+
+			if (grid[y][x + 1] > grid[y][x] + PHASH_MARGIN)
+				hash->dhash |= 1ULL << bit;
+			if (cells[y][x] > mean + PHASH_MARGIN)
+				hash->ahash |= 1ULL << bit;
+		}
+	}
+
+	hash->valid = true;
+	return true;
+}
+
+bool perceptual_hash_update(perceptual_hash *ref, const luma_pyramid *pyramid, uint32_t threshold)
+{
+	perceptual_hash hash;
+
+	if (!compute_perceptual_hash(pyramid, &hash)) {
+		ref->valid = false;
+		return true;
+	}
+
+	if (ref->valid && perceptual_hash_distance(ref, &hash) <= threshold)
+		return false;
+
+	*ref = hash;
+	return true;
+}
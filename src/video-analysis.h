@@ -0,0 +1,128 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs-module.h>
+
+#include "hash.h"
+#include "luma-pyramid.h"
+
+struct plane_layout {
+	uint32_t row_bytes;
+	uint32_t rows;
+};
+
+struct frame_layout {
+	size_t planes;
+	plane_layout plane[MAX_AV_PLANES];
+};
+
+// Fills in the visible bytes per row and row count of every plane, ignoring linesize padding.
+// Returns false for formats we don't know how to walk.
+bool get_frame_layout(enum video_format format, uint32_t width, uint32_t height, frame_layout *layout);
+
+// Keeps a tightly packed copy of the last compared frame.
+struct frame_compare {
+	enum video_format format;
+	uint32_t width;
+	uint32_t height;
+	frame_layout layout;
+
+	uint8_t *planes[MAX_AV_PLANES];
+	bool valid;
+};
+
+// Compares the frame to the stored reference and replaces the reference with it.
+// Returns true if the picture differs from the reference (or there was no usable reference).
+bool frame_compare_update(frame_compare *cmp, const struct obs_source_frame *frame);
+void frame_compare_free(frame_compare *cmp);
+
+// Hashes a fixed number of jittered samples per plane, so the cost doesn't depend on resolution.
+// Every update hashes the frame twice: once with the seed the previous frame was prepared for,
+// and once with the next seed, so consecutive compares look at different parts of the picture.
+struct frame_fingerprint {
+	enum video_format format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t samples;
+	frame_layout layout;
+
+	uint64_t seed;
+	uint64_t next_hash;
+	bool valid;
+};
+
+uint64_t hash_frame_samples(const struct obs_source_frame *frame, const frame_layout *layout, uint32_t samples,
+			    uint64_t seed);
+
+// Returns true if the sampled picture differs from the previous update (or there was no previous update).
+bool frame_fingerprint_update(frame_fingerprint *fp, const struct obs_source_frame *frame, uint32_t samples);
+
+#define TILE_MAP_MAX 16
+
+// Splits the fine level of the luma pyramid into a grid of tiles and remembers when each one last changed,
+// so a picture that is frozen except for an overlay or a small clock still shows as mostly static.
+struct tile_map {
+	uint32_t cols;
+	uint32_t rows;
+	uint32_t width;
+	uint32_t height;
+
+	// The grid actually used, smaller than asked for on tiny frames
+	uint32_t grid_cols;
+	uint32_t grid_rows;
+
+	// Tile edges in fine-level cells
+	uint32_t x_edges[TILE_MAP_MAX + 1];
+	uint32_t y_edges[TILE_MAP_MAX + 1];
+
+	// The fine level as of each tile's last change
+	uint8_t *reference;
+	size_t reference_size;
+
+	uint64_t changed_ts[TILE_MAP_MAX * TILE_MAP_MAX];
+	bool valid;
+};
+
+void tile_map_update(tile_map *map, const luma_pyramid *pyramid, uint32_t cols, uint32_t rows);
+void tile_map_free(tile_map *map);
+
+// Share of the picture area (0 to 1) in tiles that haven't changed for longer than static_ns.
+float tile_map_static_area(const tile_map *map, uint64_t now, uint64_t static_ns);
+
+// dHash and aHash of the luma pyramid boxed down to 9x8. Small brightness noise, dithering and compression
+// artifacts move the box averages far less than a real picture change, so a noisy but frozen picture
+// keeps (nearly) the same hash.
+struct perceptual_hash {
+	uint64_t dhash;
+	uint64_t ahash;
+	bool valid;
+};
+
+bool compute_perceptual_hash(const luma_pyramid *pyramid, perceptual_hash *hash);
+
+static inline uint32_t perceptual_hash_distance(const perceptual_hash *a, const perceptual_hash *b)
+{
+	return popcount64(a->dhash ^ b->dhash) + popcount64(a->ahash ^ b->ahash);
+}
+
+// Compares the frame to the reference, which is the hash of the last frame that counted as a change, so
+// slow fades still add up to a change. Returns true (and replaces the reference) when the frame is more
+// than threshold bits away from it, or there was no usable reference.
+bool perceptual_hash_update(perceptual_hash *ref, const luma_pyramid *pyramid, uint32_t threshold);
@@ -0,0 +1,619 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+// Measures the per-frame and per-packet work of the filter: filter_video and filter_audio end to end, the
+// analysis stages they run, and every SIMD kernel on each instruction set this CPU supports. Results are
+// written as JSON so runs from different releases can be compared.
+//
+// capture-checker-bench [--quick] [--output file.json] [--match text]
+
+#include "obs-stub.h"
+#include "synthetic-media.h"
+
+#include "audio-analysis.h"
+#include "luma-pyramid.h"
+#include "simd-kernels.h"
+#include "video-analysis.h"
+
+#include <plugin-support.h>
+#include <util/platform.h>
+
+#include <math.h>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define HAVE_CYCLE_COUNTER
+#endif
+
+#define FILTER_ID "capture_checker_filter"
+
+#define FRAME_NS 16666667ULL
+#define AUDIO_RATE 48000
+#define AUDIO_CHANNELS 2
+#define AUDIO_FRAMES 1024
+
+// Calls made before measuring, so buffers are sized and caches are warm
+#define WARMUP_CALLS 3
+#define MIN_CALLS 5
+
+// C++ allocations of the calling thread; the plugin's own go through bmalloc and are counted by the stub.
+// The whole new/delete family is replaced so array and over-aligned allocations are counted too.
+static thread_local uint64_t new_calls = 0;
+
+static void *counted_alloc(size_t size, size_t align)
+{
+	new_calls++;
+	if (!size)
+		size = 1;
+	if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+		return malloc(size);
+#if defined(_MSC_VER)
+	return _aligned_malloc(size, align);
+#else
+	void *ptr = nullptr;
+	return posix_memalign(&ptr, align, size) == 0 ? ptr : nullptr;
+#endif
+}
+
+static void counted_free(void *ptr, size_t align)
+{
+#if defined(_MSC_VER)
+	if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+		_aligned_free(ptr);
+		return;
+	}
+#else
+	(void)align;
+#endif
+	free(ptr);
+}
+
+static void *counted_new(size_t size, size_t align)
+{
+	if (void *ptr = counted_alloc(size, align))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+void *operator new(size_t size)
+{
+	return counted_new(size, 0);
+}
+
+void *operator new[](size_t size)
+{
+	return counted_new(size, 0);
+}
+
+void *operator new(size_t size, std::align_val_t align)
+{
+	return counted_new(size, (size_t)align);
+}
+
+void *operator new[](size_t size, std::align_val_t align)
+{
+	return counted_new(size, (size_t)align);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	return counted_alloc(size, 0);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+	return counted_alloc(size, 0);
+}
+
+void *operator new(size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+	return counted_alloc(size, (size_t)align);
+}
+
+void *operator new[](size_t size, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+	return counted_alloc(size, (size_t)align);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	counted_free(ptr, 0);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+	counted_free(ptr, 0);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	counted_free(ptr, 0);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+	counted_free(ptr, 0);
+}
+
+void operator delete(void *ptr, std::align_val_t align) noexcept
+{
+	counted_free(ptr, (size_t)align);
+}
+
+void operator delete[](void *ptr, std::align_val_t align) noexcept
+{
+	counted_free(ptr, (size_t)align);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t align) noexcept
+{
+	counted_free(ptr, (size_t)align);
+}
+
+void operator delete[](void *ptr, size_t, std::align_val_t align) noexcept
+{
+	counted_free(ptr, (size_t)align);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+	counted_free(ptr, 0);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+	counted_free(ptr, 0);
+}
+
+void operator delete(void *ptr, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+	counted_free(ptr, (size_t)align);
+}
+
+void operator delete[](void *ptr, std::align_val_t align, const std::nothrow_t &) noexcept
+{
+	counted_free(ptr, (size_t)align);
+}
+
+static uint64_t allocation_count(void)
+{
+	return new_calls + stub_allocation_count();
+}
+
+static uint64_t read_cycles(void)
+{
+#if defined(HAVE_CYCLE_COUNTER)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+struct bench_stats {
+	uint64_t calls;
+	double ns_per_call;
+	double cycles_per_call;
+	double allocs_per_call;
+};
+
+struct bench_case {
+	std::string name;
+	std::string tier;
+	const char *format;
+	uint32_t width;
+	uint32_t height;
+	const char *mode;
+	size_t bytes;
+};
+
+struct bench_options {
+	uint64_t target_ns;
+	bool quick;
+	const char *match;
+};
+
+static std::vector<std::string> results;
+
+template<typename F> static bench_stats measure(F &&fn, uint64_t target_ns)
+{
+	for (int i = 0; i < WARMUP_CALLS; i++)
+		fn();
+
+	uint64_t allocs = allocation_count();
+	uint64_t start = os_gettime_ns();
+	uint64_t start_cycles = read_cycles();
+	uint64_t calls = 0;
+	uint64_t elapsed;
+
+	do {
+		fn();
+		calls++;
+		elapsed = os_gettime_ns() - start;
+	} while (elapsed < target_ns || calls < MIN_CALLS);
+
+	bench_stats stats;
+	stats.calls = calls;
+	stats.ns_per_call = (double)elapsed / calls;
+	stats.cycles_per_call = (double)(read_cycles() - start_cycles) / calls;
+	stats.allocs_per_call = (double)(allocation_count() - allocs) / calls;
+	return stats;
+}
+
+static void append_string(std::string *json, const char *key, const char *value)
+{
+	*json += ", \"";
+	*json += key;
+	*json += "\": ";
+	if (value) {
+		*json += "\"";
+		*json += value;
+		*json += "\"";
+	} else {
+		*json += "null";
+	}
+}
+
+static void append_number(std::string *json, const char *key, double value)
+{
+	char text[64];
+	snprintf(text, sizeof(text), ", \"%s\": %.6g", key, value);
+	*json += text;
+}
+
+static void record(const bench_case &c, const bench_stats &stats)
+{
+	std::string json = "{\"name\": \"" + c.name + "\"";
+
+	append_string(&json, "tier", c.tier.c_str());
+	append_string(&json, "format", c.format);
+	if (c.width) {
+		append_number(&json, "width", c.width);
+		append_number(&json, "height", c.height);
+	}
+	append_string(&json, "mode", c.mode);
+	append_number(&json, "bytes_per_call", (double)c.bytes);
+	append_number(&json, "calls", (double)stats.calls);
+	append_number(&json, "ns_per_call", stats.ns_per_call);
+#if defined(HAVE_CYCLE_COUNTER)
+	append_number(&json, "bytes_per_cycle", stats.cycles_per_call > 0.0 ? c.bytes / stats.cycles_per_call : 0.0);
+#else
+	append_string(&json, "bytes_per_cycle", nullptr);
+#endif
+	append_number(&json, "allocs_per_call", stats.allocs_per_call);
+	json += "}";
+
+	char size[32] = "";
+	if (c.width)
+		snprintf(size, sizeof(size), "%ux%u", c.width, c.height);
+	fprintf(stderr, "%-26s %-6s %-12s %-9s %-12s %12.0f ns %6.2f allocs\n", c.name.c_str(), c.tier.c_str(),
+		c.format ? c.format : "", size, c.mode ? c.mode : "", stats.ns_per_call, stats.allocs_per_call);
+	results.push_back(json);
+}
+
+static bool selected(const bench_options &options, const std::string &name)
+{
+	return !options.match || name.find(options.match) != std::string::npos;
+}
+
+template<typename F> static void run(const bench_options &options, const bench_case &c, F &&fn)
+{
+	if (selected(options, c.name))
+		record(c, measure(fn, options.target_ns));
+}
+
+// Every kernel on every tier, over a 1080p plane's worth of data
+static void bench_kernels(const bench_options &options)
+{
+	const size_t pixels = 1920 * 1080;
+	std::vector<uint8_t> a(pixels * 4), b(pixels * 4), luma(pixels);
+	std::vector<uint16_t> sums(pixels / 8);
+	std::vector<float> samples(AUDIO_RATE);
+
+	for (size_t i = 0; i < a.size(); i++)
+		a[i] = b[i] = (uint8_t)(i * 7 + i / 4096);
+	for (size_t i = 0; i < samples.size(); i++)
+		samples[i] = (float)sin(i * 0.05);
+
+	enum simd_tier previous = simd_kernels_tier();
+
+	for (int t = SIMD_TIER_SCALAR; t < SIMD_TIER_COUNT; t++) {
+		enum simd_tier tier = (enum simd_tier)t;
+		if (!simd_tier_supported(tier))
+			continue;
+		simd_kernels_select(tier);
+
+		bench_case c = {"", simd_tier_name(tier), nullptr, 0, 0, nullptr, 0};
+		uint64_t sum, sum_sq;
+		volatile uint64_t sink = 0;
+
+		c.name = "simd_bytes_equal";
+		c.bytes = pixels * 2;
+		run(options, c, [&] { sink += simd_bytes_equal(a.data(), b.data(), pixels); });
+
+		c.name = "simd_audio_levels";
+		c.bytes = samples.size() * sizeof(float);
+		run(options, c, [&] {
+			float sum_sq_f, peak;
+			bool all_zero;
+			simd_audio_levels(samples.data(), samples.size(), &sum_sq_f, &peak, &all_zero);
+			sink += all_zero;
+		});
+
+		c.name = "simd_luma_sums_u8";
+		c.bytes = pixels;
+		run(options, c, [&] {
+			sum = sum_sq = 0;
+			simd_luma_sums_u8(a.data(), pixels, 1, 0, &sum, &sum_sq);
+			sink += sum;
+		});
+
+		c.name = "simd_extract_luma_u8";
+		c.mode = "step 4";
+		c.bytes = pixels * 4;
+		run(options, c, [&] { simd_extract_luma_u8(a.data(), pixels, 4, 1, luma.data()); });
+
+		c.name = "simd_extract_luma_u16";
+		c.mode = nullptr;
+		c.bytes = pixels * 2;
+		run(options, c, [&] { simd_extract_luma_u16((const uint16_t *)a.data(), pixels, 8, luma.data()); });
+
+		c.name = "simd_extract_luma_rgb32";
+		c.bytes = pixels * 4;
+		run(options, c, [&] { simd_extract_luma_rgb32(a.data(), pixels, true, luma.data()); });
+
+		c.name = "simd_box8_accumulate";
+		c.bytes = pixels;
+		run(options, c, [&] { simd_box8_accumulate(a.data(), pixels / 8, sums.data()); });
+
+		c.name = "simd_max_abs_diff";
+		c.bytes = pixels * 2;
+		run(options, c, [&] { sink += simd_max_abs_diff(a.data(), b.data(), pixels); });
+	}
+
+	simd_kernels_select(previous);
+}
+
+struct resolution {
+	uint32_t width;
+	uint32_t height;
+};
+
+static const resolution resolutions[] = {{1280, 720}, {1920, 1080}, {2560, 1440}, {3840, 2160}};
+static const enum video_format formats[] = {VIDEO_FORMAT_NV12, VIDEO_FORMAT_I420, VIDEO_FORMAT_BGRA,
+					    VIDEO_FORMAT_P010};
+
+struct frozen_mode_info {
+	const char *name;
+	int value;
+};
+
+// Values of the frozen_mode setting
+static const frozen_mode_info frozen_modes[] = {{"full", 0}, {"fingerprint", 1}, {"tiles", 2}, {"perceptual", 3}};
+
+// Two pictures that differ everywhere, alternated so every call sees a change
+struct frame_pair {
+	synthetic_video video[2];
+	uint64_t index;
+
+	obs_source_frame *next(void)
+	{
+		obs_source_frame *frame = &video[index & 1].frame;
+		frame->timestamp = index++ * FRAME_NS;
+		return frame;
+	}
+};
+
+static bool frame_pair_init(frame_pair *pair, enum video_format format, const resolution &res)
+{
+	pair->index = 0;
+	if (!synthetic_video_init(&pair->video[0], format, res.width, res.height) ||
+	    !synthetic_video_init(&pair->video[1], format, res.width, res.height))
+		return false;
+	synthetic_video_draw_stripes(&pair->video[1], 1);
+	return true;
+}
+
+static void bench_video(const bench_options &options)
+{
+	size_t res_count = options.quick ? 1 : sizeof(resolutions) / sizeof(resolutions[0]);
+	const char *tier = simd_tier_name(simd_kernels_tier());
+
+	for (size_t r = 0; r < res_count; r++) {
+		for (enum video_format format : formats) {
+			frame_pair pair;
+			if (!frame_pair_init(&pair, format, resolutions[r]))
+				continue;
+
+			bench_case c = {"", tier, synthetic_video_format_name(format), resolutions[r].width,
+					resolutions[r].height, nullptr, synthetic_video_bytes(&pair.video[0])};
+
+			luma_pyramid pyramid = {};
+			frame_compare cmp = {};
+			frame_fingerprint fp = {};
+			tile_map tiles = {};
+			perceptual_hash hash = {};
+			volatile uint64_t sink = 0;
+
+			c.name = "luma_pyramid_build";
+			run(options, c, [&] { sink += luma_pyramid_build(&pyramid, pair.next()); });
+
+			c.name = "luma_pyramid_stats";
+			run(options, c, [&] {
+				float mean, variance;
+				sink += luma_pyramid_stats(&pyramid, &mean, &variance);
+			});
+
+			c.name = "tile_map_update";
+			run(options, c, [&] {
+				luma_pyramid_build(&pyramid, pair.next());
+				tile_map_update(&tiles, &pyramid, 8, 8);
+			});
+
+			c.name = "compute_perceptual_hash";
+			run(options, c, [&] { sink += compute_perceptual_hash(&pyramid, &hash); });
+
+			c.name = "frame_compare_update";
+			run(options, c, [&] { sink += frame_compare_update(&cmp, pair.next()); });
+
+			c.name = "frame_fingerprint_update";
+			c.mode = "1024 samples";
+			run(options, c, [&] { sink += frame_fingerprint_update(&fp, pair.next(), 1024); });
+			c.mode = nullptr;
+
+			frame_compare_free(&cmp);
+			tile_map_free(&tiles);
+			luma_pyramid_free(&pyramid);
+
+			// The whole callback, with every video check on
+			for (const frozen_mode_info &mode : frozen_modes) {
+				obs_data_t *settings = obs_data_create();
+				obs_data_set_bool(settings, "frozen_check", true);
+				obs_data_set_int(settings, "frozen_mode", mode.value);
+				obs_data_set_bool(settings, "uniform_check", true);
+				obs_data_set_bool(settings, "cadence_check", true);
+				obs_data_set_bool(settings, "desync_check", true);
+
+				obs_source_t *parent = stub_source_create("bench source");
+				obs_source_t *filter = stub_filter_create(FILTER_ID, parent, settings);
+				obs_data_release(settings);
+
+				c.name = "filter_video";
+				c.mode = mode.name;
+				run(options, c, [&] { stub_filter_video(filter, pair.next()); });
+
+				obs_source_release(filter);
+				obs_source_release(parent);
+			}
+		}
+	}
+}
+
+static void bench_audio(const bench_options &options)
+{
+	std::vector<float> samples((size_t)AUDIO_FRAMES * AUDIO_CHANNELS);
+	obs_audio_data audio = {};
+	uint64_t ts = 0;
+
+	for (size_t i = 0; i < samples.size(); i++)
+		samples[i] = (float)(0.25 * sin(i * 0.0576));
+	for (size_t ch = 0; ch < AUDIO_CHANNELS; ch++)
+		audio.data[ch] = (uint8_t *)(samples.data() + ch * AUDIO_FRAMES);
+	audio.frames = AUDIO_FRAMES;
+
+	auto next = [&]() {
+		audio.timestamp = ts;
+		ts += 1000000000ULL * AUDIO_FRAMES / AUDIO_RATE;
+		// A different packet every time, so the loop detector never matches
+		samples[0] = (float)(ts % 1000) / 1000.0f;
+		return &audio;
+	};
+
+	bench_case c = {"", simd_tier_name(simd_kernels_tier()), "float planar", 0, 0, "stereo 1024",
+			samples.size() * sizeof(float)};
+
+	audio_levels levels = {};
+	audio_loop_detector loop = {};
+	volatile uint64_t sink = 0;
+
+	c.name = "audio_levels_update";
+	run(options, c, [&] { sink += audio_levels_update(&levels, next(), AUDIO_CHANNELS, AUDIO_RATE, 0.001f); });
+
+	c.name = "audio_loop_update";
+	run(options, c, [&] { sink += audio_loop_update(&loop, next(), AUDIO_CHANNELS, false); });
+
+	obs_data_t *settings = obs_data_create();
+	obs_data_set_bool(settings, "silence_check", true);
+	obs_data_set_bool(settings, "audio_loop_check", true);
+	obs_data_set_bool(settings, "audio_continuity_check", true);
+	obs_data_set_bool(settings, "desync_check", true);
+
+	obs_source_t *parent = stub_source_create("bench source");
+	obs_source_t *filter = stub_filter_create(FILTER_ID, parent, settings);
+	obs_data_release(settings);
+
+	c.name = "filter_audio";
+	run(options, c, [&] { stub_filter_audio(filter, next()); });
+
+	obs_source_release(filter);
+	obs_source_release(parent);
+}
+
+int main(int argc, char **argv)
+{
+	bench_options options = {200000000ULL, false, nullptr};
+	const char *output = nullptr;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--quick") == 0) {
+			options.quick = true;
+			options.target_ns = 5000000ULL;
+		} else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+			output = argv[++i];
+		} else if (strcmp(argv[i], "--match") == 0 && i + 1 < argc) {
+			options.match = argv[++i];
+		} else {
+			fprintf(stderr, "usage: %s [--quick] [--output file.json] [--match text]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	stub_set_audio_format(AUDIO_RATE, AUDIO_CHANNELS);
+	if (!stub_module_load()) {
+		fprintf(stderr, "obs_module_load failed\n");
+		return 1;
+	}
+
+	bench_kernels(options);
+	bench_video(options);
+	bench_audio(options);
+
+	stub_module_unload();
+
+	FILE *file = output ? fopen(output, "w") : stdout;
+	if (!file) {
+		fprintf(stderr, "can't write %s\n", output);
+		return 1;
+	}
+
+	fprintf(file, "{\n  \"plugin_version\": \"%s\",\n  \"simd_tier\": \"%s\",\n", PLUGIN_VERSION,
+		simd_tier_name(simd_kernels_tier()));
+#if defined(HAVE_CYCLE_COUNTER)
+	fprintf(file, "  \"cycle_counter\": \"tsc\",\n");
+#else
+	fprintf(file, "  \"cycle_counter\": null,\n");
+#endif
+	fprintf(file, "  \"results\": [\n");
+	for (size_t i = 0; i < results.size(); i++)
+		fprintf(file, "    %s%s\n", results[i].c_str(), i + 1 < results.size() ? "," : "");
+	fprintf(file, "  ]\n}\n");
+
+	if (file != stdout)
+		fclose(file);
+	return 0;
+}
@@ -0,0 +1,307 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "fault-generator.h"
+#include "obs-stub.h"
+
+#include <util/platform.h>
+#include <util/util_uint64.h>
+
+#include <math.h>
+#include <string.h>
+
+#define TONE_HZ 440.0
+#define TONE_LEVEL 0.25
+// Noise under the tone, so no two packets are ever the same and only a real loop looks like one
+#define NOISE_LEVEL 0.01
+
+void fault_generator_config_default(fault_generator_config *config)
+{
+	*config = {};
+	config->video = true;
+	config->format = VIDEO_FORMAT_NV12;
+	config->width = 1920;
+	config->height = 1080;
+	config->frame_ns = 16666667ULL;
+	config->sample_rate = 48000;
+	config->channels = 2;
+	config->audio_frames = 1024;
+	config->fault = CAPTURE_FAULT_NONE;
+	config->partial_moving_area = 0.25f;
+	config->drop_every = 2;
+	config->jump_ns = 500000000ULL;
+	config->drift_ms_per_s = 200.0;
+	config->loop_packets = 8;
+	config->speed = 1.0;
+}
+
+const char *capture_fault_name(enum capture_fault fault)
+{
+	switch (fault) {
+	case CAPTURE_FAULT_NONE:
+		return "none";
+	case CAPTURE_FAULT_FROZEN:
+		return "frozen";
+	case CAPTURE_FAULT_BLACK:
+		return "black";
+	case CAPTURE_FAULT_PARTIAL_FREEZE:
+		return "partial freeze";
+	case CAPTURE_FAULT_REPEATED_TIMESTAMP:
+		return "repeated timestamp";
+	case CAPTURE_FAULT_CADENCE_DROP:
+		return "cadence drop";
+	case CAPTURE_FAULT_NO_VIDEO:
+		return "no video";
+	case CAPTURE_FAULT_SILENCE:
+		return "silence";
+	case CAPTURE_FAULT_AUDIO_LOOP:
+		return "audio loop";
+	case CAPTURE_FAULT_TIMESTAMP_JUMP:
+		return "timestamp jump";
+	case CAPTURE_FAULT_AV_DRIFT:
+		return "A/V drift";
+	case CAPTURE_FAULT_NO_AUDIO:
+		return "no audio";
+	default:
+		return "unknown";
+	}
+}
+
+bool fault_generator_init(fault_generator *gen, const fault_generator_config *config)
+{
+	gen->config = *config;
+	if (gen->config.drop_every < 1)
+		gen->config.drop_every = 1;
+	if (gen->config.loop_packets < 1)
+		gen->config.loop_packets = 1;
+	if (gen->config.channels > MAX_AV_PLANES)
+		gen->config.channels = MAX_AV_PLANES;
+
+	if (!config->video && config->fault == CAPTURE_FAULT_NO_AUDIO)
+		return false;
+	if (!synthetic_video_init(&gen->video, config->format, config->width, config->height))
+		return false;
+	gen->black_drawn = false;
+	gen->video_index = 0;
+	gen->repeated_ts = 0;
+
+	size_t packet_samples = (size_t)gen->config.audio_frames * gen->config.channels;
+
+	gen->samples.assign(packet_samples, 0.0f);
+	gen->loop_samples.assign(packet_samples * gen->config.loop_packets, 0.0f);
+	gen->audio = {};
+	for (size_t ch = 0; ch < gen->config.channels; ch++)
+		gen->audio.data[ch] = (uint8_t *)(gen->samples.data() + ch * gen->config.audio_frames);
+	gen->audio.frames = gen->config.audio_frames;
+	gen->audio_index = 0;
+	gen->noise = 1;
+
+	gen->pending = false;
+	gen->wall_start = 0;
+	return true;
+}
+
+bool fault_generator_faulted(const fault_generator *gen, uint64_t media_ns)
+{
+	const fault_generator_config &config = gen->config;
+
+	return config.fault != CAPTURE_FAULT_NONE && media_ns >= config.fault_start_ns &&
+	       (!config.fault_end_ns || media_ns < config.fault_end_ns);
+}
+
+static uint64_t video_slot_ns(const fault_generator *gen)
+{
+	return gen->video_index * gen->config.frame_ns;
+}
+
+static uint64_t audio_slot_ns(const fault_generator *gen)
+{
+	return util_mul_div64(gen->audio_index * gen->config.audio_frames, 1000000000ULL, gen->config.sample_rate);
+}
+
+// Fills in the frame for the current video slot, returns false if the fault drops it
+static bool make_frame(fault_generator *gen, uint64_t media_ns)
+{
+	enum capture_fault fault = fault_generator_faulted(gen, media_ns) ? gen->config.fault : CAPTURE_FAULT_NONE;
+	uint64_t index = gen->video_index;
+	uint64_t timestamp = media_ns;
+
+	if (!gen->config.video)
+		return false;
+
+	switch (fault) {
+	case CAPTURE_FAULT_NO_VIDEO:
+		return false;
+	case CAPTURE_FAULT_CADENCE_DROP:
+		if (index % gen->config.drop_every)
+			return false;
+		break;
+	case CAPTURE_FAULT_REPEATED_TIMESTAMP:
+		if (!gen->repeated_ts)
+			gen->repeated_ts = media_ns;
+		timestamp = gen->repeated_ts;
+		break;
+	default:
+		gen->repeated_ts = 0;
+		break;
+	}
+
+	if (fault == CAPTURE_FAULT_BLACK) {
+		if (!gen->black_drawn)
+			synthetic_video_fill_black(&gen->video);
+		gen->black_drawn = true;
+	} else if (fault == CAPTURE_FAULT_PARTIAL_FREEZE) {
+		synthetic_video_draw_stripes_partial(&gen->video, index, gen->config.partial_moving_area);
+		gen->black_drawn = false;
+	} else if (fault != CAPTURE_FAULT_FROZEN) {
+		synthetic_video_draw_stripes(&gen->video, index);
+		gen->black_drawn = false;
+	}
+
+	gen->video.frame.timestamp = timestamp;
+	return true;
+}
+
+static float next_noise(fault_generator *gen)
+{
+	gen->noise = gen->noise * 1664525u + 1013904223u;
+	return (float)((int32_t)gen->noise / 2147483648.0);
+}
+
+static void draw_tone(fault_generator *gen, uint64_t first_sample)
+{
+	const fault_generator_config &config = gen->config;
+
+	for (size_t ch = 0; ch < config.channels; ch++) {
+		float *out = gen->samples.data() + ch * config.audio_frames;
+
+		for (uint32_t i = 0; i < config.audio_frames; i++) {
+			double t = (double)(first_sample + i) / config.sample_rate;
+			out[i] = (float)(TONE_LEVEL * sin(2.0 * M_PI * TONE_HZ * t) + NOISE_LEVEL * next_noise(gen));
+		}
+	}
+}
+
+// Fills in the packet for the current audio slot, returns false if the fault drops it
+static bool make_packet(fault_generator *gen, uint64_t media_ns)
+{
+	const fault_generator_config &config = gen->config;
+	enum capture_fault fault = fault_generator_faulted(gen, media_ns) ? config.fault : CAPTURE_FAULT_NONE;
+	size_t packet_samples = gen->samples.size();
+	float *loop_slot = gen->loop_samples.data() + (gen->audio_index % config.loop_packets) * packet_samples;
+	uint64_t timestamp = media_ns + config.av_offset_ns;
+
+	switch (fault) {
+	case CAPTURE_FAULT_NO_AUDIO:
+		return false;
+	case CAPTURE_FAULT_SILENCE:
+		memset(gen->samples.data(), 0, packet_samples * sizeof(float));
+		break;
+	case CAPTURE_FAULT_AUDIO_LOOP:
+		memcpy(gen->samples.data(), loop_slot, packet_samples * sizeof(float));
+		break;
+	default:
+		draw_tone(gen, gen->audio_index * config.audio_frames);
+		// Remember the latest packets, in case they are the ones that start looping
+		memcpy(loop_slot, gen->samples.data(), packet_samples * sizeof(float));
+		break;
+	}
+
+	// Jumps and drift are offsets from the fault start that stay once the fault is over
+	if (config.fault == CAPTURE_FAULT_TIMESTAMP_JUMP && media_ns >= config.fault_start_ns) {
+		timestamp += config.jump_ns;
+	} else if (config.fault == CAPTURE_FAULT_AV_DRIFT && media_ns >= config.fault_start_ns) {
+		uint64_t drift_end = config.fault_end_ns && media_ns > config.fault_end_ns ? config.fault_end_ns
+											    : media_ns;
+		timestamp += (uint64_t)((drift_end - config.fault_start_ns) * config.drift_ms_per_s / 1000.0);
+	}
+
+	gen->audio.timestamp = timestamp;
+	return true;
+}
+
+void fault_generator_next(fault_generator *gen, fault_event *event)
+{
+	if (gen->pending) {
+		*event = gen->pending_event;
+		gen->pending = false;
+		return;
+	}
+
+	for (;;) {
+		uint64_t video_ns = video_slot_ns(gen);
+		uint64_t audio_ns = audio_slot_ns(gen);
+
+		// Video first when both are due, like a capture that delivers the frame and then its audio
+		if (video_ns <= audio_ns) {
+			bool made = make_frame(gen, video_ns);
+			gen->video_index++;
+			if (made) {
+				*event = {video_ns, &gen->video.frame, nullptr};
+				return;
+			}
+		} else {
+			bool made = make_packet(gen, audio_ns);
+			gen->audio_index++;
+			if (made) {
+				*event = {audio_ns, nullptr, &gen->audio};
+				return;
+			}
+		}
+	}
+}
+
+uint64_t fault_generator_drive(fault_generator *gen, obs_source_t *filter, uint64_t until_ns,
+			       bool (*stop)(void *param, uint64_t media_ns), void *param, fault_drive_stats *stats)
+{
+	double speed = gen->config.speed;
+	fault_event event;
+
+	for (;;) {
+		fault_generator_next(gen, &event);
+
+		if (event.media_ns >= until_ns || (stop && stop(param, event.media_ns))) {
+			// Keep it for the next call
+			gen->pending_event = event;
+			gen->pending = true;
+			return event.media_ns;
+		}
+
+		if (speed > 0.0) {
+			if (!gen->wall_start)
+				gen->wall_start = os_gettime_ns() - (uint64_t)(event.media_ns / speed);
+			os_sleepto_ns(gen->wall_start + (uint64_t)(event.media_ns / speed));
+		}
+
+		uint64_t before = os_gettime_ns();
+
+		if (event.frame) {
+			stub_filter_video(filter, event.frame);
+			if (stats) {
+				stats->video_ns += os_gettime_ns() - before;
+				stats->video_calls++;
+			}
+		} else {
+			stub_filter_audio(filter, event.audio);
+			if (stats) {
+				stats->audio_ns += os_gettime_ns() - before;
+				stats->audio_calls++;
+			}
+		}
+	}
+}
@@ -0,0 +1,137 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs-module.h>
+
+#include "synthetic-media.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+// What goes wrong with the stream once the fault starts
+enum capture_fault {
+	CAPTURE_FAULT_NONE,
+	// The picture stops changing, timestamps keep advancing
+	CAPTURE_FAULT_FROZEN,
+	CAPTURE_FAULT_BLACK,
+	// Only the bottom partial_moving_area of the picture keeps changing
+	CAPTURE_FAULT_PARTIAL_FREEZE,
+	// Frames keep coming with the timestamp of the first faulted frame
+	CAPTURE_FAULT_REPEATED_TIMESTAMP,
+	// One frame in every drop_every is delivered
+	CAPTURE_FAULT_CADENCE_DROP,
+	CAPTURE_FAULT_NO_VIDEO,
+	CAPTURE_FAULT_SILENCE,
+	// The last loop_packets audio packets play over and over
+	CAPTURE_FAULT_AUDIO_LOOP,
+	// Audio timestamps skip jump_ns ahead once, then continue evenly from there
+	CAPTURE_FAULT_TIMESTAMP_JUMP,
+	// Audio timestamps run drift_ms_per_s faster than video
+	CAPTURE_FAULT_AV_DRIFT,
+	CAPTURE_FAULT_NO_AUDIO,
+	CAPTURE_FAULT_COUNT,
+};
+
+struct fault_generator_config {
+	// Off for an audio-only source, which never delivers a frame
+	bool video;
+	enum video_format format;
+	uint32_t width;
+	uint32_t height;
+	uint64_t frame_ns;
+
+	uint32_t sample_rate;
+	size_t channels;
+	uint32_t audio_frames;
+
+	enum capture_fault fault;
+	// Media time the fault covers, fault_end_ns 0 lasts forever
+	uint64_t fault_start_ns;
+	uint64_t fault_end_ns;
+
+	float partial_moving_area;
+	uint32_t drop_every;
+	uint64_t jump_ns;
+	double drift_ms_per_s;
+	// Added to every audio timestamp, fault or not, like the constant offset OBS's buffering leaves between streams
+	uint64_t av_offset_ns;
+	size_t loop_packets;
+
+	// Multiple of real time that fault_generator_drive runs at, 0 runs as fast as the filter allows
+	double speed;
+};
+
+// 1080p NV12 at 60 fps, 48 kHz stereo in 1024 frame packets, no fault, real time
+void fault_generator_config_default(fault_generator_config *config);
+
+const char *capture_fault_name(enum capture_fault fault);
+
+// A frame or packet, pointing into the generator's buffers until the next call.
+// media_ns is when it is due in the unfaulted stream, which is what pacing and fault times use.
+struct fault_event {
+	uint64_t media_ns;
+	struct obs_source_frame *frame;
+	struct obs_audio_data *audio;
+};
+
+struct fault_drive_stats {
+	uint64_t video_calls;
+	uint64_t video_ns;
+	uint64_t audio_calls;
+	uint64_t audio_ns;
+};
+
+// Produces a video and audio stream with one fault, allocating everything at init so producing it costs
+// only the drawing.
+struct fault_generator {
+	fault_generator_config config;
+
+	synthetic_video video;
+	bool black_drawn;
+	uint64_t video_index;
+	uint64_t repeated_ts;
+
+	std::vector<float> samples;
+	std::vector<float> loop_samples;
+	struct obs_audio_data audio;
+	uint64_t audio_index;
+	uint32_t noise;
+
+	bool pending;
+	fault_event pending_event;
+	uint64_t wall_start;
+};
+
+// Returns false for a video format the plugin can't walk, or a config that would produce nothing at all
+bool fault_generator_init(fault_generator *gen, const fault_generator_config *config);
+
+// The next frame or packet in presentation order. Dropped frames and packets are skipped over.
+void fault_generator_next(fault_generator *gen, fault_event *event);
+
+bool fault_generator_faulted(const fault_generator *gen, uint64_t media_ns);
+
+// Feeds the stream into filter's filter_video and filter_audio until media time until_ns, pacing it by
+// config.speed. stop is asked before every frame and packet and ends the run early when it returns true.
+// Calls can be chained, the stream and its pacing carry on where the last one stopped. Returns the media
+// time reached.
+uint64_t fault_generator_drive(fault_generator *gen, obs_source_t *filter, uint64_t until_ns,
+			       bool (*stop)(void *param, uint64_t media_ns), void *param, fault_drive_stats *stats);
@@ -0,0 +1,371 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+// Drives the filter callbacks with a synthetic stream for each capture fault and reports how long each check
+// takes to fire and what the callbacks cost. Runs every scenario, or the ones named on the command line. Exits
+// non-zero if a check fires early, late or not at all.
+//
+// The checker runs on a virtual clock that follows media time, so a run always sees the same times and an hour
+// long alert time takes milliseconds. --speed N runs it on the real clock instead, N times faster than real time.
+
+#include "fault-generator.h"
+#include "obs-stub.h"
+#include "virtual-clock.h"
+
+#include <checker-clock.h>
+#include <simd-kernels.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#define FILTER_ID "capture_checker_filter"
+
+// Media time that runs normally before the fault starts, and how long after its alert time the check gets to fire
+#define LEAD_NS 2000000000ULL
+#define TIMEOUT_NS 5000000000ULL
+// On the real clock the checks run on their own time, so at high speeds the lead also needs a few intervals of it
+#define MIN_LEAD_WALL_NS 300000000ULL
+#define CHECK_INTERVAL_MS 50
+// Where the virtual clock starts, the checker treats time 0 as never
+#define VIRTUAL_START_NS 1000000000ULL
+
+struct scenario {
+	const char *name;
+	enum capture_fault fault;
+	// Log text of the alert, and the setting that enables the check
+	const char *alert;
+	const char *check_setting;
+	// Alert time, interval or threshold of the check, and the least latency that allows
+	const char *time_setting;
+	uint32_t time_value;
+	uint32_t alert_ms;
+	// Anything else the check needs
+	const char *extra_setting;
+	int extra_value;
+	// Measured on the checker clock rather than in media time
+	bool checker_clock;
+	// Hides the source when the fault starts, and stops delivering anything
+	bool hide_source;
+	// A source without video
+	bool audio_only;
+	// Constant offset of the audio timestamps, in sync but stamped apart
+	uint32_t av_offset_ms;
+	// Media time after the alert that the check has to stay quiet for, 0 if it may repeat
+	uint32_t quiet_ms;
+};
+
+static const scenario scenarios[] = {
+	{"frozen-picture", CAPTURE_FAULT_FROZEN, "Frozen picture check alert", "frozen_check", "frozen_time", 1000,
+	 1000, nullptr, 0, false, false, false, 0, 0},
+	{"partial-freeze", CAPTURE_FAULT_PARTIAL_FREEZE, "Frozen picture check alert", "frozen_check", "frozen_time",
+	 1000, 1000, "frozen_mode", 2, false, false, false, 0, 0},
+	{"black-picture", CAPTURE_FAULT_BLACK, "Black/uniform picture check alert", "uniform_check", "uniform_time",
+	 1000, 1000, nullptr, 0, false, false, false, 0, 0},
+	{"video-timestamp", CAPTURE_FAULT_NO_VIDEO, "Video timestamp check alert", "video_ts_check",
+	 "video_ts_interval", 1000, 1000, nullptr, 0, true, false, false, 0, 0},
+	{"repeated-timestamp", CAPTURE_FAULT_REPEATED_TIMESTAMP, "Video timestamp check alert", "video_ts_check",
+	 "video_ts_interval", 1000, 1000, nullptr, 0, true, false, false, 0, 0},
+	// The rate has to be learned again once it settles, not half way from 60 to 30 fps
+	{"cadence-drop", CAPTURE_FAULT_CADENCE_DROP, "Frame rate check alert", "cadence_check", nullptr, 0, 0, nullptr,
+	 0, true, false, false, 0, 10000},
+	{"audio-silence", CAPTURE_FAULT_SILENCE, "Audio silence check alert", "silence_check", "silence_time", 1000,
+	 1000, nullptr, 0, false, false, false, 0, 0},
+	{"audio-only-silence", CAPTURE_FAULT_SILENCE, "Audio silence check alert", "silence_check", "silence_time",
+	 1000, 1000, nullptr, 0, false, false, true, 0, 0},
+	{"audio-loop", CAPTURE_FAULT_AUDIO_LOOP, "Stuck audio buffer check alert", "audio_loop_check",
+	 "audio_loop_time", 1000, 1000, nullptr, 0, false, false, false, 0, 0},
+	{"audio-timestamp", CAPTURE_FAULT_NO_AUDIO, "Audio timestamp check alert", "audio_ts_check",
+	 "audio_ts_interval", 1000, 1000, nullptr, 0, true, false, false, 0, 0},
+	{"timestamp-jump", CAPTURE_FAULT_TIMESTAMP_JUMP, "Audio continuity check alert", "audio_continuity_check",
+	 nullptr, 0, 0, nullptr, 0, true, false, false, 0, 0},
+	// The default 200 ms/s of drift crosses a 300 ms threshold 1.5 s in
+	{"av-drift", CAPTURE_FAULT_AV_DRIFT, "Video/Audio desync check alert", "desync_check", "desync_threshold", 300,
+	 1500, nullptr, 0, false, false, false, 0, 0},
+	// The drift is measured from the offset the streams start with, so 500 ms of buffering alone doesn't alert
+	{"av-drift-offset", CAPTURE_FAULT_AV_DRIFT, "Video/Audio desync check alert", "desync_check",
+	 "desync_threshold", 300, 1500, nullptr, 0, false, false, false, 500, 0},
+	// An hour, so only on the virtual clock
+	{"source-hidden", CAPTURE_FAULT_NONE, "Source enabled check alert", "source_enabled_check",
+	 "source_enabled_time", 3600, 3600000, nullptr, 0, true, true, false, 0, 0},
+};
+
+// Checks that are on by default, off unless a scenario is about them so only its own alert shows up
+static const char *const default_checks[] = {"video_ts_check", "audio_ts_check", "source_enabled_check"};
+
+static const char *const interval_settings[] = {
+	"video_ts_interval", "audio_ts_interval", "source_enabled_interval", "frozen_interval", "silence_interval",
+	"audio_loop_interval", "audio_continuity_interval", "desync_interval", "cadence_interval", "uniform_interval",
+};
+
+struct scenario_result {
+	bool fired;
+	uint64_t latency_ns;
+	fault_drive_stats stats;
+};
+
+// Ends a run when the alert fires, or once the check has had its time on both clocks
+struct alert_watch {
+	const scenario *s;
+	// The virtual clock reads clock_base at media time 0, unused on the real clock
+	bool virtual_clock;
+	uint64_t clock_base;
+
+	uint64_t fault_ns;
+	uint64_t fault_clock;
+	bool fired;
+	uint64_t latency_ns;
+};
+
+static bool watch_alert(void *param, uint64_t media_ns)
+{
+	alert_watch *watch = (alert_watch *)param;
+
+	// Everything up to now has arrived, let the checker catch up with it
+	if (watch->virtual_clock)
+		virtual_clock_advance_to(watch->clock_base + media_ns);
+
+	if (stub_log_count(watch->s->alert)) {
+		// The alert fired somewhere between the previous frame or packet and this one
+		watch->fired = true;
+		watch->latency_ns = watch->s->checker_clock ? checker_clock_now() - watch->fault_clock
+							    : media_ns - watch->fault_ns;
+		return true;
+	}
+
+	uint64_t timeout_ns = 1000000ULL * watch->s->alert_ms + TIMEOUT_NS;
+	return watch->fault_clock && media_ns - watch->fault_ns > timeout_ns &&
+	       checker_clock_now() - watch->fault_clock > timeout_ns;
+}
+
+// Only keeps the virtual clock up with the media
+static bool follow_media(void *param, uint64_t media_ns)
+{
+	alert_watch *watch = (alert_watch *)param;
+
+	if (watch->virtual_clock)
+		virtual_clock_advance_to(watch->clock_base + media_ns);
+	return false;
+}
+
+// speed 0 runs on the virtual clock
+static bool run_scenario(const scenario *s, double speed, scenario_result *result)
+{
+	obs_data_t *settings = obs_data_create();
+	for (const char *check : default_checks)
+		obs_data_set_bool(settings, check, false);
+	obs_data_set_bool(settings, s->check_setting, true);
+	// Check often so the latency is mostly the alert time
+	for (const char *interval : interval_settings)
+		obs_data_set_int(settings, interval, CHECK_INTERVAL_MS);
+	if (s->time_setting)
+		obs_data_set_int(settings, s->time_setting, s->time_value);
+	if (s->extra_setting)
+		obs_data_set_int(settings, s->extra_setting, s->extra_value);
+
+	obs_source_t *parent = stub_source_create("harness source");
+	obs_source_t *filter = stub_filter_create(FILTER_ID, parent, settings);
+	obs_data_release(settings);
+
+	fault_generator_config config;
+	fault_generator_config_default(&config);
+	config.video = !s->audio_only;
+	config.av_offset_ns = 1000000ULL * s->av_offset_ms;
+	config.fault = s->fault;
+	config.fault_start_ns = LEAD_NS;
+	if ((uint64_t)(MIN_LEAD_WALL_NS * speed) > config.fault_start_ns)
+		config.fault_start_ns = (uint64_t)(MIN_LEAD_WALL_NS * speed);
+	config.speed = speed;
+
+	fault_generator gen;
+	fault_generator_init(&gen, &config);
+	*result = {};
+	stub_log_clear();
+
+	alert_watch watch = {s, speed == 0.0, 0, config.fault_start_ns, 0, false, 0};
+	if (watch.virtual_clock)
+		watch.clock_base = virtual_clock_now();
+
+	fault_generator_drive(&gen, filter, config.fault_start_ns, watch_alert, &watch, &result->stats);
+	bool early = watch.fired;
+	bool repeated = false;
+
+	if (!early) {
+		watch.fault_clock = checker_clock_now();
+
+		if (s->hide_source) {
+			stub_source_set_active(parent, false);
+			for (uint64_t t = config.fault_start_ns; !watch_alert(&watch, t);)
+				t += 1000000ULL * CHECK_INTERVAL_MS;
+		} else {
+			uint64_t fired_ns = fault_generator_drive(&gen, filter, UINT64_MAX, watch_alert, &watch,
+								  &result->stats);
+			if (watch.fired && s->quiet_ms) {
+				fault_generator_drive(&gen, filter, fired_ns + 1000000ULL * s->quiet_ms, follow_media,
+						      &watch, &result->stats);
+				repeated = stub_log_count(s->alert) > 1;
+			}
+		}
+
+		result->fired = watch.fired;
+		result->latency_ns = watch.latency_ns;
+	}
+
+	obs_source_release(filter);
+	obs_source_release(parent);
+
+	if (early)
+		printf("%s: alert fired before the fault\n", s->name);
+	else if (!result->fired)
+		printf("%s: no alert within %.0f s of the fault\n", s->name, (1e6 * s->alert_ms + TIMEOUT_NS) / 1e9);
+	else if (repeated)
+		printf("%s: alert repeated within %u ms\n", s->name, s->quiet_ms);
+	return !early && result->fired && !repeated;
+}
+
+// Builds the properties like the filter dialog does, presses the refresh button, and reads back the audio levels
+// of a steady -6 dBFS tone
+static bool check_properties(void)
+{
+	obs_source_t *parent = stub_source_create("harness source");
+	obs_source_t *filter = stub_filter_create(FILTER_ID, parent, nullptr);
+
+	std::vector<float> samples(1024, 0.5f);
+	struct obs_audio_data audio = {};
+	audio.data[0] = (uint8_t *)samples.data();
+	audio.data[1] = (uint8_t *)samples.data();
+	audio.frames = (uint32_t)samples.size();
+	for (int i = 0; i < 100; i++) {
+		audio.timestamp = 1000000000ULL * audio.frames * i / 48000;
+		stub_filter_audio(filter, &audio);
+	}
+
+	obs_properties_t *props = stub_source_properties(filter);
+	bool passed = props != nullptr;
+
+	if (passed) {
+		obs_property_t *refresh = obs_properties_get(props, "cadence_refresh");
+		obs_property_t *levels = obs_properties_get(props, "audio_levels");
+		passed = refresh && obs_property_button_clicked(refresh, filter) && levels &&
+			 strstr(obs_property_description(levels), "-6.0 / -6.0, -6.0 / -6.0");
+		obs_properties_destroy(props);
+	}
+
+	obs_source_release(filter);
+	obs_source_release(parent);
+
+	printf("properties: %s\n", passed ? "ok" : "FAILED");
+	return passed;
+}
+
+// A filter on auto must not undo the tier another filter forced, and the tier goes back to auto with its owner
+static bool check_simd_tier(void)
+{
+	enum simd_tier best = simd_kernels_tier();
+	obs_data_t *settings = obs_data_create();
+	obs_data_set_int(settings, "simd_tier", SIMD_TIER_SCALAR);
+
+	obs_source_t *parent = stub_source_create("harness source");
+	obs_source_t *forced = stub_filter_create(FILTER_ID, parent, settings);
+	obs_source_t *automatic = stub_filter_create(FILTER_ID, parent, nullptr);
+	bool passed = simd_kernels_tier() == SIMD_TIER_SCALAR;
+
+	obs_source_release(forced);
+	passed = passed && simd_kernels_tier() == best;
+
+	obs_source_release(automatic);
+	obs_source_release(parent);
+	obs_data_release(settings);
+
+	printf("simd tier: %s\n", passed ? "ok" : "FAILED");
+	return passed;
+}
+
+int main(int argc, char **argv)
+{
+	double speed = 0.0;
+	std::vector<const scenario *> selected;
+	bool failed = false;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--verbose") == 0) {
+			stub_log_set_echo(true);
+		} else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+			speed = atof(argv[++i]);
+		} else {
+			const scenario *found = nullptr;
+			for (const scenario &s : scenarios) {
+				if (strcmp(s.name, argv[i]) == 0)
+					found = &s;
+			}
+			if (!found) {
+				fprintf(stderr, "unknown scenario %s\n", argv[i]);
+				return 2;
+			}
+			selected.push_back(found);
+		}
+	}
+
+	if (selected.empty()) {
+		for (const scenario &s : scenarios)
+			selected.push_back(&s);
+	}
+	if (speed < 0.0)
+		speed = 0.0;
+
+	fault_generator_config defaults;
+	fault_generator_config_default(&defaults);
+	stub_set_audio_format(defaults.sample_rate, defaults.channels);
+	if (speed == 0.0)
+		virtual_clock_install(VIRTUAL_START_NS);
+	if (!stub_module_load()) {
+		fprintf(stderr, "obs_module_load failed\n");
+		return 1;
+	}
+
+	failed |= !check_properties();
+	failed |= !check_simd_tier();
+
+	for (const scenario *s : selected) {
+		if (s->hide_source && speed != 0.0) {
+			printf("%s: skipped, needs the virtual clock\n", s->name);
+			continue;
+		}
+
+		scenario_result result;
+		bool passed = run_scenario(s, speed, &result);
+
+		if (passed && result.latency_ns < 1000000ULL * s->alert_ms) {
+			printf("%s: alert fired %.0f ms into a %u ms alert time\n", s->name, result.latency_ns / 1e6,
+			       s->alert_ms);
+			passed = false;
+		}
+
+		printf("%s: %s, latency %.0f ms %s, filter_video %.1f us, filter_audio %.2f us\n", s->name,
+		       passed ? "ok" : "FAILED", result.latency_ns / 1e6, s->checker_clock ? "checker clock" : "media",
+		       result.stats.video_calls ? result.stats.video_ns / 1e3 / result.stats.video_calls : 0.0,
+		       result.stats.audio_calls ? result.stats.audio_ns / 1e3 / result.stats.audio_calls : 0.0);
+		failed |= !passed;
+	}
+
+	stub_module_unload();
+	virtual_clock_remove();
+	return failed ? 1 : 0;
+}
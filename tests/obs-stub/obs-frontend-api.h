@@ -0,0 +1,38 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum obs_frontend_event {
+	OBS_FRONTEND_EVENT_STREAMING_STARTING,
+	OBS_FRONTEND_EVENT_EXIT = 17,
+	OBS_FRONTEND_EVENT_SCRIPTING_SHUTDOWN = 31,
+};
+
+typedef void (*obs_frontend_event_cb)(enum obs_frontend_event event, void *private_data);
+
+void obs_frontend_add_event_callback(obs_frontend_event_cb callback, void *private_data);
+void obs_frontend_remove_event_callback(obs_frontend_event_cb callback, void *private_data);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,276 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+// Stand-in for the parts of libobs the plugin uses, so its callbacks can run without OBS. Only the
+// declarations the plugin needs are here; the layouts match libobs for the fields it touches.
+
+#pragma once
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAX_AV_PLANES 8
+
+#define LOG_ERROR 100
+#define LOG_WARNING 200
+#define LOG_INFO 300
+#define LOG_DEBUG 400
+
+typedef struct obs_source obs_source_t;
+typedef struct obs_data obs_data_t;
+typedef struct obs_properties obs_properties_t;
+typedef struct obs_property obs_property_t;
+typedef struct signal_handler signal_handler_t;
+typedef struct calldata calldata_t;
+typedef struct audio_output audio_t;
+
+enum video_format {
+	VIDEO_FORMAT_NONE,
+	VIDEO_FORMAT_I420,
+	VIDEO_FORMAT_NV12,
+	VIDEO_FORMAT_YVYU,
+	VIDEO_FORMAT_YUY2,
+	VIDEO_FORMAT_UYVY,
+	VIDEO_FORMAT_RGBA,
+	VIDEO_FORMAT_BGRA,
+	VIDEO_FORMAT_BGRX,
+	VIDEO_FORMAT_Y800,
+	VIDEO_FORMAT_I444,
+	VIDEO_FORMAT_BGR3,
+	VIDEO_FORMAT_I422,
+	VIDEO_FORMAT_I40A,
+	VIDEO_FORMAT_I42A,
+	VIDEO_FORMAT_YUVA,
+	VIDEO_FORMAT_AYUV,
+	VIDEO_FORMAT_I010,
+	VIDEO_FORMAT_P010,
+	VIDEO_FORMAT_I210,
+	VIDEO_FORMAT_I412,
+	VIDEO_FORMAT_YA2L,
+	VIDEO_FORMAT_P216,
+	VIDEO_FORMAT_P416,
+	VIDEO_FORMAT_V210,
+	VIDEO_FORMAT_R10L,
+};
+
+enum audio_format {
+	AUDIO_FORMAT_UNKNOWN,
+	AUDIO_FORMAT_U8BIT,
+	AUDIO_FORMAT_16BIT,
+	AUDIO_FORMAT_32BIT,
+	AUDIO_FORMAT_FLOAT,
+	AUDIO_FORMAT_U8BIT_PLANAR,
+	AUDIO_FORMAT_16BIT_PLANAR,
+	AUDIO_FORMAT_32BIT_PLANAR,
+	AUDIO_FORMAT_FLOAT_PLANAR,
+};
+
+enum speaker_layout {
+	SPEAKERS_UNKNOWN,
+	SPEAKERS_MONO,
+	SPEAKERS_STEREO,
+	SPEAKERS_2POINT1,
+	SPEAKERS_4POINT0,
+	SPEAKERS_4POINT1,
+	SPEAKERS_5POINT1,
+	SPEAKERS_7POINT1 = 8,
+};
+
+struct obs_source_frame {
+	uint8_t *data[MAX_AV_PLANES];
+	uint32_t linesize[MAX_AV_PLANES];
+	uint32_t width;
+	uint32_t height;
+	uint64_t timestamp;
+
+	enum video_format format;
+	float color_matrix[16];
+	bool full_range;
+	uint16_t max_luminance;
+	float color_range_min[3];
+	float color_range_max[3];
+	bool flip;
+	uint8_t flags;
+	uint8_t trc;
+
+	volatile long refs;
+	bool prev_frame;
+};
+
+// Audio filters get planar float samples
+struct obs_audio_data {
+	uint8_t *data[MAX_AV_PLANES];
+	uint32_t frames;
+	uint64_t timestamp;
+};
+
+struct obs_source_audio {
+	const uint8_t *data[MAX_AV_PLANES];
+	uint32_t frames;
+
+	enum speaker_layout speakers;
+	enum audio_format format;
+	uint32_t samples_per_sec;
+
+	uint64_t timestamp;
+};
+
+enum obs_source_type {
+	OBS_SOURCE_TYPE_INPUT,
+	OBS_SOURCE_TYPE_FILTER,
+	OBS_SOURCE_TYPE_TRANSITION,
+	OBS_SOURCE_TYPE_SCENE,
+};
+
+enum obs_text_type {
+	OBS_TEXT_DEFAULT,
+	OBS_TEXT_PASSWORD,
+	OBS_TEXT_MULTILINE,
+	OBS_TEXT_INFO,
+};
+
+enum obs_combo_type {
+	OBS_COMBO_TYPE_INVALID,
+	OBS_COMBO_TYPE_EDITABLE,
+	OBS_COMBO_TYPE_LIST,
+	OBS_COMBO_TYPE_RADIO,
+};
+
+enum obs_combo_format {
+	OBS_COMBO_FORMAT_INVALID,
+	OBS_COMBO_FORMAT_INT,
+	OBS_COMBO_FORMAT_FLOAT,
+	OBS_COMBO_FORMAT_STRING,
+	OBS_COMBO_FORMAT_BOOL,
+};
+
+enum obs_monitoring_type {
+	OBS_MONITORING_TYPE_NONE,
+	OBS_MONITORING_TYPE_MONITOR_ONLY,
+	OBS_MONITORING_TYPE_MONITOR_AND_OUTPUT,
+};
+
+#define OBS_SOURCE_VIDEO (1 << 0)
+#define OBS_SOURCE_AUDIO (1 << 1)
+#define OBS_SOURCE_ASYNC (1 << 2)
+#define OBS_SOURCE_CAP_DISABLED (1 << 10)
+
+typedef bool (*obs_property_clicked_t)(obs_properties_t *props, obs_property_t *property, void *data);
+typedef void (*signal_callback_t)(void *data, calldata_t *cd);
+
+struct obs_source_info {
+	const char *id;
+	enum obs_source_type type;
+	uint32_t output_flags;
+
+	const char *(*get_name)(void *type_data);
+	void *(*create)(obs_data_t *settings, obs_source_t *source);
+	void (*destroy)(void *data);
+	void (*get_defaults)(obs_data_t *settings);
+	obs_properties_t *(*get_properties)(void *data);
+	void (*update)(void *data, obs_data_t *settings);
+	struct obs_source_frame *(*filter_video)(void *data, struct obs_source_frame *frame);
+	struct obs_audio_data *(*filter_audio)(void *data, struct obs_audio_data *audio);
+	void (*get_defaults2)(void *type_data, obs_data_t *settings);
+};
+
+// Memory
+void *bmalloc(size_t size);
+void *bzalloc(size_t size);
+void *brealloc(void *ptr, size_t size);
+void bfree(void *ptr);
+
+// Logging
+void blog(int log_level, const char *format, ...);
+void blogva(int log_level, const char *format, va_list args);
+
+// Module
+bool obs_module_load(void);
+void obs_module_unload(void);
+const char *obs_module_text(const char *lookup_string);
+// Under the stub's own folder in the temp directory, free with bfree
+char *obs_module_config_path(const char *file);
+
+#define OBS_DECLARE_MODULE()
+#define OBS_MODULE_USE_DEFAULT_LOCALE(module_name, default_locale)
+
+void obs_register_source_s(const struct obs_source_info *info, size_t size);
+#define obs_register_source(info) obs_register_source_s(info, sizeof(struct obs_source_info))
+
+// Sources
+obs_source_t *obs_source_create_private(const char *id, const char *name, obs_data_t *settings);
+void obs_source_release(obs_source_t *source);
+obs_source_t *obs_filter_get_parent(const obs_source_t *filter);
+bool obs_source_enabled(const obs_source_t *source);
+bool obs_source_active(const obs_source_t *source);
+signal_handler_t *obs_source_get_signal_handler(const obs_source_t *source);
+void obs_source_output_audio(obs_source_t *source, const struct obs_source_audio *audio);
+void obs_source_set_monitoring_type(obs_source_t *source, enum obs_monitoring_type type);
+void obs_source_set_audio_mixers(obs_source_t *source, uint32_t mixers);
+
+// Signals
+void signal_handler_connect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data);
+void signal_handler_disconnect(signal_handler_t *handler, const char *signal, signal_callback_t callback,
+			       void *data);
+bool calldata_bool(const calldata_t *data, const char *name);
+
+// Settings
+obs_data_t *obs_data_create(void);
+void obs_data_addref(obs_data_t *data);
+void obs_data_release(obs_data_t *data);
+void obs_data_set_bool(obs_data_t *data, const char *name, bool val);
+void obs_data_set_int(obs_data_t *data, const char *name, long long val);
+void obs_data_set_default_bool(obs_data_t *data, const char *name, bool val);
+void obs_data_set_default_int(obs_data_t *data, const char *name, long long val);
+bool obs_data_get_bool(obs_data_t *data, const char *name);
+long long obs_data_get_int(obs_data_t *data, const char *name);
+
+// Properties
+obs_properties_t *obs_properties_create(void);
+void obs_properties_destroy(obs_properties_t *props);
+obs_property_t *obs_properties_get(obs_properties_t *props, const char *property);
+obs_property_t *obs_properties_add_bool(obs_properties_t *props, const char *name, const char *description);
+obs_property_t *obs_properties_add_int(obs_properties_t *props, const char *name, const char *description, int min,
+				       int max, int step);
+obs_property_t *obs_properties_add_int_slider(obs_properties_t *props, const char *name, const char *description,
+					      int min, int max, int step);
+obs_property_t *obs_properties_add_text(obs_properties_t *props, const char *name, const char *description,
+					enum obs_text_type type);
+obs_property_t *obs_properties_add_button(obs_properties_t *props, const char *name, const char *text,
+					  obs_property_clicked_t callback);
+obs_property_t *obs_properties_add_list(obs_properties_t *props, const char *name, const char *description,
+					enum obs_combo_type type, enum obs_combo_format format);
+size_t obs_property_list_add_int(obs_property_t *p, const char *name, long long val);
+size_t obs_property_list_item_count(obs_property_t *p);
+const char *obs_property_description(obs_property_t *p);
+bool obs_property_button_clicked(obs_property_t *p, void *obj);
+
+// Audio output
+audio_t *obs_get_audio(void);
+uint32_t audio_output_get_sample_rate(const audio_t *audio);
+size_t audio_output_get_channels(const audio_t *audio);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,710 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "obs-stub.h"
+
+#include <util/platform.h>
+#include <util/threading.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct obs_data {
+	std::atomic<long> refs{1};
+	std::map<std::string, long long> values;
+	std::map<std::string, long long> defaults;
+};
+
+struct calldata {
+	std::map<std::string, bool> bools;
+};
+
+struct signal_connection {
+	std::string signal;
+	signal_callback_t callback;
+	void *data;
+};
+
+struct signal_handler {
+	std::mutex mutex;
+	std::vector<signal_connection> connections;
+};
+
+struct obs_source {
+	std::atomic<long> refs{1};
+	std::string name;
+	const obs_source_info *info;
+	void *data;
+	obs_data_t *settings;
+	obs_source_t *parent;
+	std::atomic<bool> enabled{true};
+	std::atomic<bool> active{true};
+	signal_handler signals;
+};
+
+struct obs_property {
+	std::string name;
+	std::string description;
+	obs_properties_t *parent;
+	obs_property_clicked_t clicked;
+	std::vector<std::pair<std::string, long long>> items;
+};
+
+struct obs_properties {
+	std::vector<std::unique_ptr<obs_property>> properties;
+};
+
+struct audio_output {
+	uint32_t sample_rate;
+	size_t channels;
+};
+
+struct os_event_data {
+	std::mutex mutex;
+	std::condition_variable cond;
+	bool signalled;
+	bool manual;
+};
+
+struct log_message {
+	uint64_t time;
+	int level;
+	std::string text;
+};
+
+struct frontend_callback {
+	obs_frontend_event_cb callback;
+	void *data;
+};
+
+// Registered types live as long as the process, like in OBS
+static std::vector<std::unique_ptr<obs_source_info>> source_types;
+static std::vector<frontend_callback> frontend_callbacks;
+static audio_output audio = {48000, 2};
+
+static thread_local uint64_t allocations = 0;
+
+static std::mutex log_mutex;
+static std::condition_variable log_cond;
+static std::vector<log_message> log_messages;
+static bool log_echo = false;
+
+static const obs_source_info *find_type(const char *id)
+{
+	for (const auto &info : source_types) {
+		if (strcmp(info->id, id) == 0)
+			return info.get();
+	}
+	return nullptr;
+}
+
+static void apply_defaults(obs_source_t *source)
+{
+	if (source->info->get_defaults2)
+		source->info->get_defaults2(nullptr, source->settings);
+	else if (source->info->get_defaults)
+		source->info->get_defaults(source->settings);
+}
+
+static void copy_values(obs_data_t *to, obs_data_t *from)
+{
+	if (from) {
+		for (const auto &value : from->values)
+			to->values[value.first] = value.second;
+	}
+}
+
+static obs_source_t *create_source(const obs_source_info *info, const char *name, obs_source_t *parent,
+				   obs_data_t *settings)
+{
+	obs_source_t *source = new obs_source;
+	source->name = name ? name : "";
+	source->info = info;
+	source->data = nullptr;
+	source->settings = obs_data_create();
+	source->parent = parent;
+
+	if (info) {
+		apply_defaults(source);
+		copy_values(source->settings, settings);
+		source->data = info->create(source->settings, source);
+	}
+
+	return source;
+}
+
+static void emit_enable(obs_source_t *source, bool enabled)
+{
+	calldata data;
+	data.bools["enabled"] = enabled;
+
+	std::vector<signal_connection> connections;
+	{
+		std::lock_guard<std::mutex> lock(source->signals.mutex);
+		connections = source->signals.connections;
+	}
+
+	for (const auto &connection : connections) {
+		if (connection.signal == "enable")
+			connection.callback(connection.data, &data);
+	}
+}
+
+extern "C" {
+
+void *bmalloc(size_t size)
+{
+	allocations++;
+	return malloc(size ? size : 1);
+}
+
+void *bzalloc(size_t size)
+{
+	allocations++;
+	return calloc(1, size ? size : 1);
+}
+
+void *brealloc(void *ptr, size_t size)
+{
+	allocations++;
+	return realloc(ptr, size ? size : 1);
+}
+
+void bfree(void *ptr)
+{
+	free(ptr);
+}
+
+void blogva(int log_level, const char *format, va_list args)
+{
+	char text[4096];
+	vsnprintf(text, sizeof(text), format, args);
+
+	std::lock_guard<std::mutex> lock(log_mutex);
+
+	log_messages.push_back(log_message{os_gettime_ns(), log_level, text});
+	if (log_echo)
+		printf("%s\n", text);
+	log_cond.notify_all();
+}
+
+void blog(int log_level, const char *format, ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	blogva(log_level, format, args);
+	va_end(args);
+}
+
+const char *obs_module_text(const char *lookup_string)
+{
+	return lookup_string;
+}
+
+char *obs_module_config_path(const char *file)
+{
+	std::error_code error;
+	std::string path = (std::filesystem::temp_directory_path(error) / "capture-checker-stub").string() + "/" + file;
+	char *copy = (char *)bmalloc(path.size() + 1);
+
+	memcpy(copy, path.c_str(), path.size() + 1);
+	return copy;
+}
+
+void obs_register_source_s(const struct obs_source_info *info, size_t size)
+{
+	auto copy = std::make_unique<obs_source_info>();
+	memcpy(copy.get(), info, std::min(size, sizeof(obs_source_info)));
+	source_types.push_back(std::move(copy));
+}
+
+obs_source_t *obs_source_create_private(const char *id, const char *name, obs_data_t *settings)
+{
+	const obs_source_info *info = find_type(id);
+
+	return info ? create_source(info, name, nullptr, settings) : nullptr;
+}
+
+void obs_source_release(obs_source_t *source)
+{
+	if (!source || --source->refs > 0)
+		return;
+
+	if (source->info && source->info->destroy)
+		source->info->destroy(source->data);
+	obs_data_release(source->settings);
+	delete source;
+}
+
+obs_source_t *obs_filter_get_parent(const obs_source_t *filter)
+{
+	return filter->parent;
+}
+
+bool obs_source_enabled(const obs_source_t *source)
+{
+	return source && source->enabled;
+}
+
+bool obs_source_active(const obs_source_t *source)
+{
+	return source && source->active;
+}
+
+signal_handler_t *obs_source_get_signal_handler(const obs_source_t *source)
+{
+	return const_cast<signal_handler_t *>(&source->signals);
+}
+
+void obs_source_output_audio(obs_source_t *, const struct obs_source_audio *) {}
+
+void obs_source_set_monitoring_type(obs_source_t *, enum obs_monitoring_type) {}
+
+void obs_source_set_audio_mixers(obs_source_t *, uint32_t) {}
+
+void signal_handler_connect(signal_handler_t *handler, const char *signal, signal_callback_t callback, void *data)
+{
+	std::lock_guard<std::mutex> lock(handler->mutex);
+	handler->connections.push_back(signal_connection{signal, callback, data});
+}
+
+void signal_handler_disconnect(signal_handler_t *handler, const char *signal, signal_callback_t callback,
+			       void *data)
+{
+	std::lock_guard<std::mutex> lock(handler->mutex);
+	auto &connections = handler->connections;
+
+	connections.erase(std::remove_if(connections.begin(), connections.end(),
+					 [&](const signal_connection &c) {
+						 return c.signal == signal && c.callback == callback && c.data == data;
+					 }),
+			  connections.end());
+}
+
+bool calldata_bool(const calldata_t *data, const char *name)
+{
+	auto it = data->bools.find(name);
+	return it != data->bools.end() && it->second;
+}
+
+obs_data_t *obs_data_create(void)
+{
+	return new obs_data;
+}
+
+void obs_data_addref(obs_data_t *data)
+{
+	if (data)
+		data->refs++;
+}
+
+void obs_data_release(obs_data_t *data)
+{
+	if (data && --data->refs == 0)
+		delete data;
+}
+
+void obs_data_set_bool(obs_data_t *data, const char *name, bool val)
+{
+	data->values[name] = val;
+}
+
+void obs_data_set_int(obs_data_t *data, const char *name, long long val)
+{
+	data->values[name] = val;
+}
+
+void obs_data_set_default_bool(obs_data_t *data, const char *name, bool val)
+{
+	data->defaults[name] = val;
+}
+
+void obs_data_set_default_int(obs_data_t *data, const char *name, long long val)
+{
+	data->defaults[name] = val;
+}
+
+long long obs_data_get_int(obs_data_t *data, const char *name)
+{
+	auto it = data->values.find(name);
+	if (it != data->values.end())
+		return it->second;
+
+	it = data->defaults.find(name);
+	return it != data->defaults.end() ? it->second : 0;
+}
+
+bool obs_data_get_bool(obs_data_t *data, const char *name)
+{
+	return obs_data_get_int(data, name) != 0;
+}
+
+obs_properties_t *obs_properties_create(void)
+{
+	return new obs_properties;
+}
+
+void obs_properties_destroy(obs_properties_t *props)
+{
+	delete props;
+}
+
+obs_property_t *obs_properties_get(obs_properties_t *props, const char *property)
+{
+	for (const auto &p : props->properties) {
+		if (p->name == property)
+			return p.get();
+	}
+	return nullptr;
+}
+
+static obs_property_t *add_property(obs_properties_t *props, const char *name, const char *description)
+{
+	auto p = std::make_unique<obs_property>();
+	p->name = name;
+	p->description = description ? description : "";
+	p->parent = props;
+	p->clicked = nullptr;
+
+	props->properties.push_back(std::move(p));
+	return props->properties.back().get();
+}
+
+obs_property_t *obs_properties_add_bool(obs_properties_t *props, const char *name, const char *description)
+{
+	return add_property(props, name, description);
+}
+
+obs_property_t *obs_properties_add_int(obs_properties_t *props, const char *name, const char *description, int, int,
+				       int)
+{
+	return add_property(props, name, description);
+}
+
+obs_property_t *obs_properties_add_int_slider(obs_properties_t *props, const char *name, const char *description,
+					      int, int, int)
+{
+	return add_property(props, name, description);
+}
+
+obs_property_t *obs_properties_add_text(obs_properties_t *props, const char *name, const char *description,
+					enum obs_text_type)
+{
+	return add_property(props, name, description);
+}
+
+obs_property_t *obs_properties_add_button(obs_properties_t *props, const char *name, const char *text,
+					  obs_property_clicked_t callback)
+{
+	obs_property_t *p = add_property(props, name, text);
+	p->clicked = callback;
+	return p;
+}
+
+obs_property_t *obs_properties_add_list(obs_properties_t *props, const char *name, const char *description,
+					enum obs_combo_type, enum obs_combo_format)
+{
+	return add_property(props, name, description);
+}
+
+size_t obs_property_list_add_int(obs_property_t *p, const char *name, long long val)
+{
+	p->items.emplace_back(name, val);
+	return p->items.size() - 1;
+}
+
+size_t obs_property_list_item_count(obs_property_t *p)
+{
+	return p->items.size();
+}
+
+const char *obs_property_description(obs_property_t *p)
+{
+	return p->description.c_str();
+}
+
+bool obs_property_button_clicked(obs_property_t *p, void *obj)
+{
+	obs_source_t *source = (obs_source_t *)obj;
+
+	return p->clicked && p->clicked(p->parent, p, source ? source->data : nullptr);
+}
+
+audio_t *obs_get_audio(void)
+{
+	return &audio;
+}
+
+uint32_t audio_output_get_sample_rate(const audio_t *output)
+{
+	return output->sample_rate;
+}
+
+size_t audio_output_get_channels(const audio_t *output)
+{
+	return output->channels;
+}
+
+void obs_frontend_add_event_callback(obs_frontend_event_cb callback, void *private_data)
+{
+	frontend_callbacks.push_back(frontend_callback{callback, private_data});
+}
+
+void obs_frontend_remove_event_callback(obs_frontend_event_cb callback, void *private_data)
+{
+	frontend_callbacks.erase(std::remove_if(frontend_callbacks.begin(), frontend_callbacks.end(),
+						[&](const frontend_callback &c) {
+							return c.callback == callback && c.data == private_data;
+						}),
+				 frontend_callbacks.end());
+}
+
+uint64_t os_gettime_ns(void)
+{
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+bool os_sleepto_ns(uint64_t time_target)
+{
+	uint64_t now = os_gettime_ns();
+
+	if (time_target <= now)
+		return false;
+
+	std::this_thread::sleep_for(std::chrono::nanoseconds(time_target - now));
+	return true;
+}
+
+void os_sleep_ms(uint32_t duration)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(duration));
+}
+
+FILE *os_fopen(const char *path, const char *mode)
+{
+	return fopen(path, mode);
+}
+
+int os_stat(const char *file, struct stat *st)
+{
+	return stat(file, st);
+}
+
+int os_mkdirs(const char *path)
+{
+	std::error_code error;
+
+	if (std::filesystem::is_directory(path, error))
+		return MKDIR_EXISTS;
+	return std::filesystem::create_directories(path, error) ? MKDIR_SUCCESS : MKDIR_ERROR;
+}
+
+int os_event_init(os_event_t **event, enum os_event_type type)
+{
+	*event = new os_event_data;
+	(*event)->signalled = false;
+	(*event)->manual = type == OS_EVENT_TYPE_MANUAL;
+	return 0;
+}
+
+void os_event_destroy(os_event_t *event)
+{
+	delete event;
+}
+
+int os_event_wait(os_event_t *event)
+{
+	std::unique_lock<std::mutex> lock(event->mutex);
+
+	event->cond.wait(lock, [event] { return event->signalled; });
+	if (!event->manual)
+		event->signalled = false;
+	return 0;
+}
+
+int os_event_timedwait(os_event_t *event, unsigned long milliseconds)
+{
+	std::unique_lock<std::mutex> lock(event->mutex);
+
+	if (!event->cond.wait_for(lock, std::chrono::milliseconds(milliseconds), [event] { return event->signalled; }))
+		return ETIMEDOUT;
+	if (!event->manual)
+		event->signalled = false;
+	return 0;
+}
+
+int os_event_try(os_event_t *event)
+{
+	std::lock_guard<std::mutex> lock(event->mutex);
+
+	if (!event->signalled)
+		return EAGAIN;
+	if (!event->manual)
+		event->signalled = false;
+	return 0;
+}
+
+int os_event_signal(os_event_t *event)
+{
+	std::lock_guard<std::mutex> lock(event->mutex);
+
+	event->signalled = true;
+	event->cond.notify_all();
+	return 0;
+}
+
+void os_event_reset(os_event_t *event)
+{
+	std::lock_guard<std::mutex> lock(event->mutex);
+	event->signalled = false;
+}
+}
+
+bool stub_module_load(void)
+{
+	return obs_module_load();
+}
+
+void stub_module_unload(void)
+{
+	stub_frontend_event(OBS_FRONTEND_EVENT_EXIT);
+	obs_module_unload();
+}
+
+obs_source_t *stub_source_create(const char *name)
+{
+	return create_source(nullptr, name, nullptr, nullptr);
+}
+
+obs_source_t *stub_filter_create(const char *id, obs_source_t *parent, obs_data_t *settings)
+{
+	const obs_source_info *info = find_type(id);
+
+	return info ? create_source(info, id, parent, settings) : nullptr;
+}
+
+void stub_source_update(obs_source_t *source, obs_data_t *settings)
+{
+	copy_values(source->settings, settings);
+	if (source->info && source->info->update)
+		source->info->update(source->data, source->settings);
+}
+
+obs_properties_t *stub_source_properties(obs_source_t *source)
+{
+	return source->info && source->info->get_properties ? source->info->get_properties(source->data) : nullptr;
+}
+
+struct obs_source_frame *stub_filter_video(obs_source_t *filter, struct obs_source_frame *frame)
+{
+	return filter->info->filter_video ? filter->info->filter_video(filter->data, frame) : frame;
+}
+
+struct obs_audio_data *stub_filter_audio(obs_source_t *filter, struct obs_audio_data *audio_data)
+{
+	return filter->info->filter_audio ? filter->info->filter_audio(filter->data, audio_data) : audio_data;
+}
+
+void stub_source_set_enabled(obs_source_t *source, bool enabled)
+{
+	if (source->enabled.exchange(enabled) != enabled)
+		emit_enable(source, enabled);
+}
+
+void stub_source_set_active(obs_source_t *source, bool active)
+{
+	source->active = active;
+}
+
+uint64_t stub_allocation_count(void)
+{
+	return allocations;
+}
+
+void stub_set_audio_format(uint32_t sample_rate, size_t channels)
+{
+	audio.sample_rate = sample_rate;
+	audio.channels = channels;
+}
+
+void stub_frontend_event(enum obs_frontend_event event)
+{
+	std::vector<frontend_callback> callbacks = frontend_callbacks;
+
+	for (const auto &c : callbacks)
+		c.callback(event, c.data);
+}
+
+void stub_log_set_echo(bool echo)
+{
+	std::lock_guard<std::mutex> lock(log_mutex);
+	log_echo = echo;
+}
+
+void stub_log_clear(void)
+{
+	std::lock_guard<std::mutex> lock(log_mutex);
+	log_messages.clear();
+}
+
+static size_t count_locked(const char *text, uint64_t *last_time)
+{
+	size_t count = 0;
+
+	for (const auto &message : log_messages) {
+		if (message.text.find(text) != std::string::npos) {
+			count++;
+			*last_time = message.time;
+		}
+	}
+	return count;
+}
+
+size_t stub_log_count(const char *text)
+{
+	std::lock_guard<std::mutex> lock(log_mutex);
+	uint64_t time;
+
+	return count_locked(text, &time);
+}
+
+uint64_t stub_log_wait(const char *text, size_t count, uint64_t timeout_ns)
+{
+	std::unique_lock<std::mutex> lock(log_mutex);
+	uint64_t time = 0;
+
+	if (log_cond.wait_for(lock, std::chrono::nanoseconds(timeout_ns),
+			      [&] { return count_locked(text, &time) >= count; }))
+		return time;
+	return 0;
+}
@@ -0,0 +1,67 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+// Control side of the libobs stand-in: what OBS itself would do to a loaded plugin.
+
+#pragma once
+
+#include <obs-frontend-api.h>
+#include <obs-module.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+// obs_module_load and obs_module_unload as OBS runs them at startup and shutdown. Unloading sends the
+// frontend exit event first, like closing OBS does.
+bool stub_module_load(void);
+void stub_module_unload(void);
+
+// A plain input source for filters to sit on. Release with obs_source_release.
+obs_source_t *stub_source_create(const char *name);
+
+// Creates a filter of a registered type on parent. The type's defaults are applied before settings, which
+// may be null. Release with obs_source_release.
+obs_source_t *stub_filter_create(const char *id, obs_source_t *parent, obs_data_t *settings);
+
+// Applies settings on top of the current ones and calls the update callback, like the properties dialog.
+void stub_source_update(obs_source_t *source, obs_data_t *settings);
+obs_properties_t *stub_source_properties(obs_source_t *source);
+
+struct obs_source_frame *stub_filter_video(obs_source_t *filter, struct obs_source_frame *frame);
+struct obs_audio_data *stub_filter_audio(obs_source_t *filter, struct obs_audio_data *audio);
+
+// Enabling or disabling emits the "enable" signal. Sources start enabled and active.
+void stub_source_set_enabled(obs_source_t *source, bool enabled);
+void stub_source_set_active(obs_source_t *source, bool active);
+
+// Calls to bmalloc, bzalloc and brealloc made by the calling thread so far
+uint64_t stub_allocation_count(void);
+
+// What obs_get_audio reports, 48 kHz stereo unless changed
+void stub_set_audio_format(uint32_t sample_rate, size_t channels);
+
+void stub_frontend_event(enum obs_frontend_event event);
+
+// Every blogva message is kept with its os_gettime_ns arrival time. Echo prints them as they arrive.
+void stub_log_set_echo(bool echo);
+void stub_log_clear(void);
+size_t stub_log_count(const char *text);
+
+// Waits until count messages containing text have arrived. Returns the arrival time of the last of them,
+// or 0 if timeout_ns passed first.
+uint64_t stub_log_wait(const char *text, size_t count, uint64_t timeout_ns);
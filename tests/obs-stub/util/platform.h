@@ -0,0 +1,46 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct stat;
+
+uint64_t os_gettime_ns(void);
+bool os_sleepto_ns(uint64_t time_target);
+void os_sleep_ms(uint32_t duration);
+
+FILE *os_fopen(const char *path, const char *mode);
+int os_stat(const char *file, struct stat *st);
+
+#define MKDIR_EXISTS 1
+#define MKDIR_SUCCESS 0
+#define MKDIR_ERROR -1
+
+int os_mkdirs(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,44 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct os_event_data os_event_t;
+
+enum os_event_type {
+	OS_EVENT_TYPE_AUTO,
+	OS_EVENT_TYPE_MANUAL,
+};
+
+int os_event_init(os_event_t **event, enum os_event_type type);
+void os_event_destroy(os_event_t *event);
+int os_event_wait(os_event_t *event);
+int os_event_timedwait(os_event_t *event, unsigned long milliseconds);
+int os_event_try(os_event_t *event);
+int os_event_signal(os_event_t *event);
+void os_event_reset(os_event_t *event);
+
+#ifdef __cplusplus
+}
+#endif
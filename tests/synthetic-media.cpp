@@ -0,0 +1,165 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "synthetic-media.h"
+
+#include <string.h>
+
+// Stripes repeat every 256 rows, and a row is offset by 4 bytes from the one above it
+#define STRIPE_PERIOD 256
+#define STRIPE_STEP 4
+
+bool synthetic_video_init(synthetic_video *video, enum video_format format, uint32_t width, uint32_t height)
+{
+	if (!get_frame_layout(format, width, height, &video->layout))
+		return false;
+
+	video->frame = {};
+	video->frame.format = format;
+	video->frame.width = width;
+	video->frame.height = height;
+
+	uint32_t widest = 0;
+
+	for (size_t i = 0; i < MAX_AV_PLANES; i++) {
+		const plane_layout &plane = video->layout.plane[i];
+
+		video->planes[i].assign((size_t)plane.row_bytes * plane.rows, 0);
+		video->frame.data[i] = i < video->layout.planes ? video->planes[i].data() : nullptr;
+		video->frame.linesize[i] = i < video->layout.planes ? plane.row_bytes : 0;
+		if (i < video->layout.planes && plane.row_bytes > widest)
+			widest = plane.row_bytes;
+	}
+
+	video->stripes.resize((size_t)widest + STRIPE_PERIOD * STRIPE_STEP);
+	for (size_t x = 0; x < video->stripes.size(); x++)
+		video->stripes[x] = (uint8_t)(x / STRIPE_STEP * 7);
+
+	synthetic_video_draw_stripes(video, 0);
+	return true;
+}
+
+size_t synthetic_video_bytes(const synthetic_video *video)
+{
+	size_t bytes = 0;
+
+	for (size_t i = 0; i < video->layout.planes; i++)
+		bytes += video->planes[i].size();
+	return bytes;
+}
+
+void synthetic_video_draw_stripes_partial(synthetic_video *video, uint64_t index, float moving_area)
+{
+	for (size_t i = 0; i < video->layout.planes; i++) {
+		const plane_layout &plane = video->layout.plane[i];
+		uint32_t moving_rows = (uint32_t)(plane.rows * moving_area + 0.5f);
+
+		for (uint32_t y = plane.rows - moving_rows; y < plane.rows; y++) {
+			size_t offset = (size_t)((y + index) % STRIPE_PERIOD) * STRIPE_STEP;
+			memcpy(video->planes[i].data() + (size_t)y * plane.row_bytes, video->stripes.data() + offset,
+			       plane.row_bytes);
+		}
+	}
+}
+
+void synthetic_video_draw_stripes(synthetic_video *video, uint64_t index)
+{
+	synthetic_video_draw_stripes_partial(video, index, 1.0f);
+}
+
+// Bytes that repeat across a row of black in each plane
+struct black_pattern {
+	uint8_t bytes[8];
+	size_t size;
+};
+
+static void pack_v210_words(black_pattern *pattern)
+{
+	// Cb Y Cr, Y Cb Y, Cr Y Cb, Y Cr Y: the first and third words are the same, as are the second and fourth
+	uint32_t chroma_first = 512 | 64 << 10 | 512u << 20;
+	uint32_t luma_first = 64 | 512 << 10 | 64u << 20;
+
+	memcpy(pattern->bytes, &chroma_first, 4);
+	memcpy(pattern->bytes + 4, &luma_first, 4);
+	pattern->size = 8;
+}
+
+static black_pattern get_black_pattern(enum video_format format, size_t plane)
+{
+	black_pattern pattern = {{16}, 1};
+
+	switch (format) {
+	case VIDEO_FORMAT_I420:
+	case VIDEO_FORMAT_I444:
+	case VIDEO_FORMAT_NV12:
+		pattern.bytes[0] = plane == 0 ? 16 : 128;
+		break;
+	case VIDEO_FORMAT_YUY2:
+		pattern = {{16, 128}, 2};
+		break;
+	case VIDEO_FORMAT_RGBA:
+	case VIDEO_FORMAT_BGRA:
+		pattern = {{0, 0, 0, 255}, 4};
+		break;
+	case VIDEO_FORMAT_P010:
+		// 10 bit values in the top of little endian 16 bit words
+		pattern = {{0x00, (uint8_t)(plane == 0 ? 0x10 : 0x80)}, 2};
+		break;
+	case VIDEO_FORMAT_V210:
+		pack_v210_words(&pattern);
+		break;
+	default:
+		break;
+	}
+	return pattern;
+}
+
+void synthetic_video_fill_black(synthetic_video *video)
+{
+	for (size_t i = 0; i < video->layout.planes; i++) {
+		black_pattern pattern = get_black_pattern(video->frame.format, i);
+		std::vector<uint8_t> &plane = video->planes[i];
+
+		for (size_t x = 0; x < plane.size(); x++)
+			plane[x] = pattern.bytes[x % pattern.size];
+	}
+}
+
+const char *synthetic_video_format_name(enum video_format format)
+{
+	switch (format) {
+	case VIDEO_FORMAT_I420:
+		return "I420";
+	case VIDEO_FORMAT_NV12:
+		return "NV12";
+	case VIDEO_FORMAT_YUY2:
+		return "YUY2";
+	case VIDEO_FORMAT_RGBA:
+		return "RGBA";
+	case VIDEO_FORMAT_BGRA:
+		return "BGRA";
+	case VIDEO_FORMAT_I444:
+		return "I444";
+	case VIDEO_FORMAT_P010:
+		return "P010";
+	case VIDEO_FORMAT_V210:
+		return "V210";
+	default:
+		return "other";
+	}
+}
@@ -0,0 +1,54 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <obs-module.h>
+
+#include "video-analysis.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+// A frame of any format the plugin can walk, with its planes allocated once up front.
+struct synthetic_video {
+	frame_layout layout;
+	std::vector<uint8_t> planes[MAX_AV_PLANES];
+	struct obs_source_frame frame;
+
+	// One row of stripes plus a full period, each row of a picture is a window into it
+	std::vector<uint8_t> stripes;
+};
+
+bool synthetic_video_init(synthetic_video *video, enum video_format format, uint32_t width, uint32_t height);
+
+// Picture bytes of the frame, without linesize padding
+size_t synthetic_video_bytes(const synthetic_video *video);
+
+// Diagonal stripes in every plane that move with index, so consecutive frames always differ
+void synthetic_video_draw_stripes(synthetic_video *video, uint64_t index);
+
+// Stripes in only the bottom moving_area of every plane, leaving the rest of the picture as it was
+void synthetic_video_draw_stripes_partial(synthetic_video *video, uint64_t index, float moving_area);
+
+// Video black in the frame's own format
+void synthetic_video_fill_black(synthetic_video *video);
+
+const char *synthetic_video_format_name(enum video_format format);
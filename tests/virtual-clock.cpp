@@ -0,0 +1,106 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#include "virtual-clock.h"
+
+#include <checker-clock.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// How long virtual_clock_advance_to waits for a scheduler that never goes back to waiting, in case it isn't
+// running at all
+#define SETTLE_TIMEOUT_MS 1000
+
+static std::mutex clock_mutex;
+static std::condition_variable clock_cond;
+static uint64_t clock_now = 0;
+
+// The scheduler blocked in virtual_wait, if any
+static bool waiting = false;
+static uint64_t waiting_deadline = 0;
+static os_event_t *waiting_event = nullptr;
+
+static uint64_t virtual_now(void *)
+{
+	std::lock_guard<std::mutex> lock(clock_mutex);
+	return clock_now;
+}
+
+static void virtual_wait(void *, os_event_t *event, uint64_t deadline)
+{
+	{
+		std::lock_guard<std::mutex> lock(clock_mutex);
+		if (deadline <= clock_now)
+			return;
+
+		waiting = true;
+		waiting_deadline = deadline;
+		waiting_event = event;
+	}
+	clock_cond.notify_all();
+
+	// Ended by virtual_clock_advance_to once the deadline is reached, or by whoever else signals the event
+	os_event_wait(event);
+
+	std::lock_guard<std::mutex> lock(clock_mutex);
+	waiting = false;
+}
+
+static const checker_clock virtual_clock = {virtual_now, virtual_wait, nullptr};
+
+void virtual_clock_install(uint64_t start_ns)
+{
+	{
+		std::lock_guard<std::mutex> lock(clock_mutex);
+		clock_now = start_ns;
+		waiting = false;
+	}
+	checker_clock_set(&virtual_clock);
+}
+
+void virtual_clock_remove(void)
+{
+	checker_clock_set(nullptr);
+}
+
+uint64_t virtual_clock_now(void)
+{
+	return virtual_now(nullptr);
+}
+
+void virtual_clock_advance_to(uint64_t now_ns)
+{
+	std::unique_lock<std::mutex> lock(clock_mutex);
+
+	if (now_ns <= clock_now)
+		return;
+	clock_now = now_ns;
+
+	if (waiting && waiting_deadline > clock_now)
+		return;
+
+	if (waiting) {
+		// Cleared here rather than by the scheduler, so the wait below can't see this wait as the next one
+		waiting = false;
+		os_event_signal(waiting_event);
+	}
+
+	clock_cond.wait_for(lock, std::chrono::milliseconds(SETTLE_TIMEOUT_MS), [] { return waiting; });
+}
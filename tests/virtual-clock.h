@@ -0,0 +1,35 @@
+/*
+Capture Checker
+Copyright (C) <2025> <Janne Pitkänen> <acebanzkux@gmail.com>
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program. If not, see <https://www.gnu.org/licenses/>
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// A checker clock that only moves when the test moves it, so checks with long alert times can run in
+// milliseconds and the same scenario always sees the same times.
+
+// Installs it as the checker clock, call before stub_module_load. start_ns must not be 0.
+void virtual_clock_install(uint64_t start_ns);
+// After stub_module_unload
+void virtual_clock_remove(void);
+
+uint64_t virtual_clock_now(void);
+
+// Moves the clock forward to now_ns and returns once the checker scheduler has run everything that was due by
+// then and is waiting again. Earlier times are ignored.
+void virtual_clock_advance_to(uint64_t now_ns);